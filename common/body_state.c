@@ -0,0 +1,19 @@
+#include "body_state.h"
+
+#define SPAWN_GRID 16
+#define SPAWN_SPACING 1.5f
+
+void GetSpawnPosition(int index, float height, float out[3]) {
+    if (index == 0) {
+        out[0] = 0.0f;
+        out[1] = height;
+        out[2] = 0.0f;
+        return;
+    }
+
+    int k = index - 1;
+    int layer = k / (SPAWN_GRID * SPAWN_GRID);
+    out[0] = ((float)(k % SPAWN_GRID) - 0.5f * (SPAWN_GRID - 1)) * SPAWN_SPACING;
+    out[1] = height + SPAWN_SPACING * (float)(layer + 1);
+    out[2] = ((float)((k / SPAWN_GRID) % SPAWN_GRID) - 0.5f * (SPAWN_GRID - 1)) * SPAWN_SPACING;
+}
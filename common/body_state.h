@@ -0,0 +1,23 @@
+// Engine independent snapshot of one dynamic body, filled by each demo every step.
+#ifndef BODY_STATE_H
+#define BODY_STATE_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct BodyState {
+    float position[3];
+    float rotation[4];      // Quaternion x, y, z, w
+    float halfExtents[3];   // Box half size
+} BodyState;
+
+// Spawn point for body index. Body 0 is the demo's original cube (x = z = 0 at height),
+// the rest are stacked in 16 x 16 layers above it.
+void GetSpawnPosition(int index, float height, float out[3]);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // BODY_STATE_H
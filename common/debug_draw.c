@@ -0,0 +1,238 @@
+#include "debug_draw.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "perf_timer.h"
+
+// Private rlgl batch: 64k quads worth of vertices per buffer, two buffers
+// so a flush does not wait on the one the GPU is still reading
+#define DEBUG_BATCH_BUFFERS 2
+#define DEBUG_BATCH_ELEMENTS 65536
+// rlgl flushes on its own once a buffer is within 4 vertices of full,
+// stay below that so every rlBegin/rlEnd chunk is exactly one draw call
+#define DEBUG_BATCH_VERTICES (DEBUG_BATCH_ELEMENTS * 4 - 4)
+
+static const struct {
+    DebugDrawCategory category;
+    int key;
+    const char *name;
+} categoryKeys[] = {
+    { DEBUG_DRAW_SHAPES, KEY_F1, "shapes" },
+    { DEBUG_DRAW_CONTACTS, KEY_F2, "contacts" },
+    { DEBUG_DRAW_AABBS, KEY_F3, "aabbs" },
+    { DEBUG_DRAW_CONSTRAINTS, KEY_F4, "constraints" },
+    { DEBUG_DRAW_BROADPHASE, KEY_F5, "broadphase" },
+};
+
+bool InitDebugDraw(DebugDraw *draw, int maxPrimitives, unsigned int categories) {
+    memset(draw, 0, sizeof(*draw));
+    if (maxPrimitives < 1024) maxPrimitives = 1024;
+    draw->categories = categories & DEBUG_DRAW_ALL;
+    draw->maxPrimitives = maxPrimitives;
+
+    draw->lineCapacity = maxPrimitives;
+    draw->lineVertices = (float *)malloc(sizeof(float) * 6 * (size_t)draw->lineCapacity);
+    draw->lineColors = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)draw->lineCapacity);
+    draw->triangleCapacity = maxPrimitives / 4;
+    draw->triangleVertices = (float *)malloc(sizeof(float) * 9 * (size_t)draw->triangleCapacity);
+    draw->triangleColors = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)draw->triangleCapacity);
+
+    rlRenderBatch *batch = (rlRenderBatch *)malloc(sizeof(rlRenderBatch));
+    *batch = rlLoadRenderBatch(DEBUG_BATCH_BUFFERS, DEBUG_BATCH_ELEMENTS);
+    draw->batch = batch;
+
+    if (!draw->lineVertices || !draw->lineColors || !draw->triangleVertices || !draw->triangleColors) {
+        TraceLog(LOG_WARNING, "DEBUG DRAW: Failed to allocate buffers for %d primitives", maxPrimitives);
+        UnloadDebugDraw(draw);
+        return false;
+    }
+    return true;
+}
+
+void UnloadDebugDraw(DebugDraw *draw) {
+    if (draw->batch) {
+        rlUnloadRenderBatch(*(rlRenderBatch *)draw->batch);
+        free(draw->batch);
+    }
+    free(draw->lineVertices);
+    free(draw->lineColors);
+    free(draw->triangleVertices);
+    free(draw->triangleColors);
+    memset(draw, 0, sizeof(*draw));
+}
+
+void BeginDebugDraw(DebugDraw *draw) {
+    draw->lineCount = 0;
+    draw->triangleCount = 0;
+    draw->dropped = 0;
+}
+
+bool IsDebugDrawEnabled(const DebugDraw *draw, unsigned int categories) {
+    return (draw->categories & categories) != 0;
+}
+
+void DebugDrawLine(DebugDraw *draw, unsigned int category, const float from[3], const float to[3], uint32_t color) {
+    if (!(draw->categories & category)) return;
+    if (draw->lineCount == draw->lineCapacity || draw->lineCount + draw->triangleCount >= draw->maxPrimitives) {
+        draw->dropped++;
+        return;
+    }
+
+    float *v = draw->lineVertices + 6 * draw->lineCount;
+    v[0] = from[0]; v[1] = from[1]; v[2] = from[2];
+    v[3] = to[0]; v[4] = to[1]; v[5] = to[2];
+    draw->lineColors[draw->lineCount++] = color;
+}
+
+void DebugDrawTriangle(DebugDraw *draw, unsigned int category,
+                       const float v0[3], const float v1[3], const float v2[3], uint32_t color) {
+    if (!(draw->categories & category)) return;
+    if (draw->triangleCount == draw->triangleCapacity || draw->lineCount + draw->triangleCount >= draw->maxPrimitives) {
+        draw->dropped++;
+        return;
+    }
+
+    float *v = draw->triangleVertices + 9 * draw->triangleCount;
+    memcpy(v, v0, sizeof(float) * 3);
+    memcpy(v + 3, v1, sizeof(float) * 3);
+    memcpy(v + 6, v2, sizeof(float) * 3);
+    draw->triangleColors[draw->triangleCount++] = color;
+}
+
+// Corner i has bit 0 = +x, bit 1 = +y, bit 2 = +z
+static void drawBoxEdges(DebugDraw *draw, unsigned int category, const float corners[8][3], uint32_t color) {
+    static const int edges[12][2] = {
+        { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },     // x
+        { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },     // y
+        { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },     // z
+    };
+    for (int i = 0; i < 12; i++) DebugDrawLine(draw, category, corners[edges[i][0]], corners[edges[i][1]], color);
+}
+
+void DebugDrawBox(DebugDraw *draw, unsigned int category, const float min[3], const float max[3], uint32_t color) {
+    if (!(draw->categories & category)) return;
+
+    float corners[8][3];
+    for (int i = 0; i < 8; i++) {
+        corners[i][0] = (i & 1) ? max[0] : min[0];
+        corners[i][1] = (i & 2) ? max[1] : min[1];
+        corners[i][2] = (i & 4) ? max[2] : min[2];
+    }
+    drawBoxEdges(draw, category, corners, color);
+}
+
+void DebugDrawOrientedBox(DebugDraw *draw, unsigned int category, const float center[3],
+                          const float axes[9], const float halfExtents[3], uint32_t color) {
+    if (!(draw->categories & category)) return;
+
+    float corners[8][3];
+    for (int i = 0; i < 8; i++) {
+        float sx = (i & 1) ? halfExtents[0] : -halfExtents[0];
+        float sy = (i & 2) ? halfExtents[1] : -halfExtents[1];
+        float sz = (i & 4) ? halfExtents[2] : -halfExtents[2];
+        for (int k = 0; k < 3; k++) corners[i][k] = center[k] + axes[k] * sx + axes[3 + k] * sy + axes[6 + k] * sz;
+    }
+    drawBoxEdges(draw, category, corners, color);
+}
+
+void DebugDrawContact(DebugDraw *draw, const float point[3], const float normal[3], uint32_t color) {
+    if (!(draw->categories & DEBUG_DRAW_CONTACTS)) return;
+
+    const float size = 0.05f;
+    const float length = 0.3f;
+    for (int k = 0; k < 3; k++) {
+        float a[3] = { point[0], point[1], point[2] };
+        float b[3] = { point[0], point[1], point[2] };
+        a[k] -= size;
+        b[k] += size;
+        DebugDrawLine(draw, DEBUG_DRAW_CONTACTS, a, b, color);
+    }
+    float tip[3] = { point[0] + normal[0] * length, point[1] + normal[1] * length, point[2] + normal[2] * length };
+    DebugDrawLine(draw, DEBUG_DRAW_CONTACTS, point, tip, color);
+}
+
+static void setColor(uint32_t color) {
+    rlColor4ub((unsigned char)(color & 0xff), (unsigned char)((color >> 8) & 0xff),
+               (unsigned char)((color >> 16) & 0xff), (unsigned char)(color >> 24));
+}
+
+void SubmitDebugDraw(DebugDraw *draw) {
+    double start = PerfNowSeconds();
+    draw->drawCalls = 0;
+    if (draw->lineCount == 0 && draw->triangleCount == 0) {
+        draw->submitSeconds = 0.0;
+        return;
+    }
+
+    // Flushes whatever raylib had queued in its default batch first
+    rlSetRenderBatchActive((rlRenderBatch *)draw->batch);
+
+    const int linesPerBatch = DEBUG_BATCH_VERTICES / 2;
+    for (int first = 0; first < draw->lineCount; first += linesPerBatch) {
+        int last = first + linesPerBatch < draw->lineCount ? first + linesPerBatch : draw->lineCount;
+        uint32_t current = draw->lineColors[first];
+        rlBegin(RL_LINES);
+        setColor(current);
+        for (int i = first; i < last; i++) {
+            if (draw->lineColors[i] != current) {
+                current = draw->lineColors[i];
+                setColor(current);
+            }
+            const float *v = draw->lineVertices + 6 * i;
+            rlVertex3f(v[0], v[1], v[2]);
+            rlVertex3f(v[3], v[4], v[5]);
+        }
+        rlEnd();
+        rlDrawRenderBatchActive();
+        draw->drawCalls++;
+    }
+
+    // Engines do not agree on winding, draw both sides
+    rlDisableBackfaceCulling();
+    const int trianglesPerBatch = DEBUG_BATCH_VERTICES / 3;
+    for (int first = 0; first < draw->triangleCount; first += trianglesPerBatch) {
+        int last = first + trianglesPerBatch < draw->triangleCount ? first + trianglesPerBatch : draw->triangleCount;
+        uint32_t current = draw->triangleColors[first];
+        rlBegin(RL_TRIANGLES);
+        setColor(current);
+        for (int i = first; i < last; i++) {
+            if (draw->triangleColors[i] != current) {
+                current = draw->triangleColors[i];
+                setColor(current);
+            }
+            const float *v = draw->triangleVertices + 9 * i;
+            rlVertex3f(v[0], v[1], v[2]);
+            rlVertex3f(v[3], v[4], v[5]);
+            rlVertex3f(v[6], v[7], v[8]);
+        }
+        rlEnd();
+        rlDrawRenderBatchActive();
+        draw->drawCalls++;
+    }
+    rlEnableBackfaceCulling();
+
+    rlSetRenderBatchActive(NULL);
+    draw->submitSeconds = PerfNowSeconds() - start;
+}
+
+void UpdateDebugDrawToggles(DebugDraw *draw) {
+    for (size_t i = 0; i < sizeof(categoryKeys) / sizeof(categoryKeys[0]); i++) {
+        if (IsKeyPressed(categoryKeys[i].key)) draw->categories ^= (unsigned int)categoryKeys[i].category;
+    }
+}
+
+void DrawDebugDrawStats(const DebugDraw *draw, int x, int y) {
+    for (size_t i = 0; i < sizeof(categoryKeys) / sizeof(categoryKeys[0]); i++) {
+        bool on = (draw->categories & categoryKeys[i].category) != 0;
+        DrawText(TextFormat("F%d %s", (int)i + 1, categoryKeys[i].name), x + (int)i * 120, y, 10, on ? DARKGREEN : GRAY);
+    }
+    if (draw->categories == 0) return;
+
+    DrawText(TextFormat("Debug: %d lines, %d triangles, %d dropped (max %d), %d draw calls, %.2f ms submit",
+                        draw->lineCount, draw->triangleCount, draw->dropped, draw->maxPrimitives,
+                        draw->drawCalls, draw->submitSeconds * 1000.0),
+             x, y + 14, 10, draw->dropped > 0 ? MAROON : DARKGRAY);
+}
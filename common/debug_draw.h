@@ -0,0 +1,89 @@
+// Batched physics debug drawing shared by the four engine adapters.
+//
+// Adapters push the engine's lines and triangles into preallocated buffers
+// during the frame; SubmitDebugDraw then hands them to rlgl through a large
+// private render batch, one draw call per full batch instead of one per shape.
+// No raylib types here so the C++ demos can include it outside `namespace rl`.
+#ifndef DEBUG_DRAW_H
+#define DEBUG_DRAW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef enum DebugDrawCategory {
+    DEBUG_DRAW_SHAPES      = 1 << 0,    // Collision shape wireframes (F1)
+    DEBUG_DRAW_CONTACTS    = 1 << 1,    // Contact points and normals (F2)
+    DEBUG_DRAW_AABBS       = 1 << 2,    // Per body bounding boxes (F3)
+    DEBUG_DRAW_CONSTRAINTS = 1 << 3,    // Joints and their limits (F4)
+    DEBUG_DRAW_BROADPHASE  = 1 << 4,    // Broadphase tree nodes / bounds (F5)
+} DebugDrawCategory;
+
+#define DEBUG_DRAW_ALL 0x1f
+#define DEBUG_DRAW_DEFAULT_MAX (1 << 20)    // Primitives per frame
+
+// Packed like raylib's Color and Jolt's Color: r in the low byte
+#define DEBUG_DRAW_RGBA(r, g, b, a) \
+    ((uint32_t)(r) | ((uint32_t)(g) << 8) | ((uint32_t)(b) << 16) | ((uint32_t)(a) << 24))
+
+typedef struct DebugDraw {
+    unsigned int categories;    // Enabled DebugDrawCategory bits
+    int maxPrimitives;          // Lines + triangles kept per frame, the rest are dropped
+
+    float *lineVertices;        // 2 points (x, y, z) per line
+    uint32_t *lineColors;       // 1 per line
+    int lineCount;
+    int lineCapacity;
+
+    float *triangleVertices;    // 3 points per triangle
+    uint32_t *triangleColors;
+    int triangleCount;
+    int triangleCapacity;
+
+    int dropped;                // Primitives over maxPrimitives this frame
+    int drawCalls;              // Batches flushed by the last submit
+    double submitSeconds;
+
+    void *batch;                // rlRenderBatch, owned
+} DebugDraw;
+
+// Needs the window (GL context). Line buffers hold maxPrimitives, triangle
+// buffers a quarter of that: adapters draw wireframes, triangles are rare.
+bool InitDebugDraw(DebugDraw *draw, int maxPrimitives, unsigned int categories);
+void UnloadDebugDraw(DebugDraw *draw);
+
+// Clears the buffers, call before the engine step so contacts reported
+// during the step are kept
+void BeginDebugDraw(DebugDraw *draw);
+
+// True when any of the given categories is on, adapters skip work otherwise
+bool IsDebugDrawEnabled(const DebugDraw *draw, unsigned int categories);
+
+void DebugDrawLine(DebugDraw *draw, unsigned int category, const float from[3], const float to[3], uint32_t color);
+void DebugDrawTriangle(DebugDraw *draw, unsigned int category,
+                       const float v0[3], const float v1[3], const float v2[3], uint32_t color);
+
+// Axis aligned box, 12 lines
+void DebugDrawBox(DebugDraw *draw, unsigned int category, const float min[3], const float max[3], uint32_t color);
+// Box with a column-major 3x3 rotation (columns are the local axes), 12 lines
+void DebugDrawOrientedBox(DebugDraw *draw, unsigned int category, const float center[3],
+                          const float axes[9], const float halfExtents[3], uint32_t color);
+// Small cross at the point plus the normal, 4 lines
+void DebugDrawContact(DebugDraw *draw, const float point[3], const float normal[3], uint32_t color);
+
+// Flushes everything through rlgl, call between BeginMode3D and EndMode3D
+void SubmitDebugDraw(DebugDraw *draw);
+
+// F1..F5 toggle the categories
+void UpdateDebugDrawToggles(DebugDraw *draw);
+// Category state, primitive counts, drops and submit cost
+void DrawDebugDrawStats(const DebugDraw *draw, int x, int y);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // DEBUG_DRAW_H
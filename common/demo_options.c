@@ -0,0 +1,81 @@
+#include "demo_options.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug_draw.h"
+#include "net_protocol.h"
+#include "net_server.h"
+#include "shared_state.h"
+#include "terrain_mesh.h"
+
+// Reads the optional integer following argv[*i], keeping fallback when absent
+static int optionalInt(int argc, char **argv, int *i, int fallback) {
+    if (*i + 1 < argc && argv[*i + 1][0] != '-') {
+        (*i)++;
+        return atoi(argv[*i]);
+    }
+    return fallback;
+}
+
+// Same for an optional word, points into argv
+static const char *optionalString(int argc, char **argv, int *i, const char *fallback) {
+    if (*i + 1 < argc && argv[*i + 1][0] != '-') {
+        (*i)++;
+        return argv[*i];
+    }
+    return fallback;
+}
+
+void ParseDemoOptions(DemoOptions *options, int argc, char **argv) {
+    options->terrainCells = 0;
+    options->benchCookIterations = 0;
+    options->bodyCount = 1;
+    options->serverPort = 0;
+    options->tickRate = 60.0f;
+    options->serverBudget = NET_DEFAULT_BUDGET;
+    options->debugDrawCategories = 0;
+    options->debugDrawMax = DEBUG_DRAW_DEFAULT_MAX;
+    options->profileSteps = 0;
+    options->sharedStateName = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--terrain") == 0) {
+            options->terrainCells = optionalInt(argc, argv, &i, 128);
+            if (options->terrainCells < 0) options->terrainCells = 0;
+            if (options->terrainCells > TERRAIN_MAX_CELLS) options->terrainCells = TERRAIN_MAX_CELLS;
+        } else if (strcmp(argv[i], "--bench-cook") == 0) {
+            options->benchCookIterations = optionalInt(argc, argv, &i, 5);
+            if (options->benchCookIterations < 1) options->benchCookIterations = 1;
+        } else if (strcmp(argv[i], "--bodies") == 0) {
+            options->bodyCount = optionalInt(argc, argv, &i, options->bodyCount);
+            if (options->bodyCount < 1) options->bodyCount = 1;
+            if (options->bodyCount > NET_MAX_BODIES) options->bodyCount = NET_MAX_BODIES;
+        } else if (strcmp(argv[i], "--server") == 0) {
+            options->serverPort = optionalInt(argc, argv, &i, NET_DEFAULT_PORT);
+            if (options->serverPort <= 0 || options->serverPort > 65535) options->serverPort = NET_DEFAULT_PORT;
+        } else if (strcmp(argv[i], "--tick-rate") == 0) {
+            options->tickRate = (float)optionalInt(argc, argv, &i, 60);
+            if (options->tickRate < 1.0f) options->tickRate = 1.0f;
+        } else if (strcmp(argv[i], "--budget") == 0) {
+            options->serverBudget = optionalInt(argc, argv, &i, options->serverBudget);
+            if (options->serverBudget < NET_MAX_PACKET) options->serverBudget = NET_MAX_PACKET;
+        } else if (strcmp(argv[i], "--debug-draw") == 0) {
+            options->debugDrawCategories = optionalInt(argc, argv, &i, DEBUG_DRAW_ALL) & DEBUG_DRAW_ALL;
+        } else if (strcmp(argv[i], "--debug-max") == 0) {
+            options->debugDrawMax = optionalInt(argc, argv, &i, options->debugDrawMax);
+            if (options->debugDrawMax < 1024) options->debugDrawMax = 1024;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            options->profileSteps = optionalInt(argc, argv, &i, 600);
+            if (options->profileSteps < 1) options->profileSteps = 1;
+        } else if (strcmp(argv[i], "--shm") == 0) {
+            options->sharedStateName = optionalString(argc, argv, &i, SHARED_STATE_DEFAULT_NAME);
+        } else {
+            printf("Unknown option: %s\n", argv[i]);
+        }
+    }
+
+    // The benchmark needs a mesh to cook even when the demo would run without one
+    if (options->benchCookIterations > 0 && options->terrainCells == 0) options->terrainCells = 128;
+}
@@ -0,0 +1,29 @@
+// Command line options shared by all four demos.
+#ifndef DEMO_OPTIONS_H
+#define DEMO_OPTIONS_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct DemoOptions {
+    int terrainCells;         // --terrain [N] : cells per side of the static terrain mesh, 0 (default) disables it
+    int benchCookIterations;  // --bench-cook [N] : time cooked vs build-from-scratch terrain startup and exit
+    int bodyCount;            // --bodies N    : dynamic cubes, the first one is the demo's original cube
+    int serverPort;           // --server [PORT] : run headless and stream state to net_viewer, 0 = windowed
+    float tickRate;           // --tick-rate HZ : server steps per second
+    int serverBudget;         // --budget BYTES : default bytes per tick per viewer
+    int debugDrawCategories;  // --debug-draw [MASK] : DebugDrawCategory bits on at startup (F1..F5 toggle)
+    int debugDrawMax;         // --debug-max N : debug primitives kept per frame
+    int profileSteps;         // --profile [N] : step N times headless, print the phase breakdown, export CSV and exit
+    const char *sharedStateName;  // --shm [NAME] : publish body transforms to shared memory for shm_viewer, NULL = off
+} DemoOptions;
+
+// Fills options with defaults, then applies argv. Unknown arguments are reported and ignored.
+void ParseDemoOptions(DemoOptions *options, int argc, char **argv);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // DEMO_OPTIONS_H
@@ -0,0 +1,174 @@
+#include "net_client.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "perf_timer.h"
+
+#define NET_CAMERA_INTERVAL 0.5
+#define NET_COMMAND_RESEND 0.1
+
+static void sendCamera(NetClient *client, double now) {
+    uint8_t buffer[64];
+    NetWriter writer;
+    NetWriterInit(&writer, buffer, sizeof(buffer));
+    NetWriteCamera(&writer, &client->camera);
+    NetSocketSend(&client->socket, &client->server, buffer, writer.size);
+    client->lastCameraSend = now;
+}
+
+static void sendCommand(NetClient *client, double now) {
+    uint8_t buffer[32];
+    NetWriter writer;
+    NetWriterInit(&writer, buffer, sizeof(buffer));
+    NetWriteCommand(&writer, &client->command);
+    NetSocketSend(&client->socket, &client->server, buffer, writer.size);
+    client->lastCommandSend = now;
+}
+
+static void recordLatency(NetClientStats *stats, float milliseconds) {
+    if (stats->latencyCount == stats->latencyCapacity) {
+        stats->latencyCapacity = stats->latencyCapacity ? stats->latencyCapacity * 2 : 1024;
+        stats->latencies = (float *)realloc(stats->latencies, sizeof(float) * (size_t)stats->latencyCapacity);
+    }
+    stats->latencies[stats->latencyCount++] = milliseconds;
+}
+
+static void ensureBodies(NetClient *client, int count) {
+    if (count <= client->bodyCount) return;
+    client->bodies = (NetBodyView *)realloc(client->bodies, sizeof(NetBodyView) * (size_t)count);
+    memset(client->bodies + client->bodyCount, 0, sizeof(NetBodyView) * (size_t)(count - client->bodyCount));
+    client->bodyCount = count;
+}
+
+static void handleState(NetClient *client, NetReader *reader, int size, double now) {
+    NetStateHeader header;
+    if (!NetReadStateHeader(reader, &header)) return;
+    NetClientStats *stats = &client->stats;
+
+    // Several packets can share a tick, account bytes and latency per tick
+    if (stats->ticks == 0 || header.tick > client->latestTick) {
+        if (stats->ticks == 0) stats->firstTick = header.tick;
+        stats->ticks++;
+        stats->lastTick = header.tick;
+        client->latestTick = header.tick;
+        client->tickBytes = 0;
+        recordLatency(stats, (float)((now - header.serverTime) * 1000.0));
+    }
+    if (header.tick == client->latestTick) {
+        client->tickBytes += (uint32_t)size;
+        if (client->tickBytes > stats->maxTickBytes) stats->maxTickBytes = client->tickBytes;
+    }
+    stats->packets++;
+    stats->bytes += (uint64_t)size;
+
+    if (client->commandPending && header.commandAck >= client->command.sequence) {
+        double rtt = now - header.commandEchoTime;
+        stats->commandRttSum += rtt;
+        if (rtt > stats->commandRttMax) stats->commandRttMax = rtt;
+        stats->commandRtts++;
+        client->commandPending = false;
+    }
+
+    ensureBodies(client, header.bodyCount);
+    for (int i = 0; i < header.entryCount; i++) {
+        NetStateEntry entry;
+        if (!NetReadStateEntry(reader, &entry) || entry.id >= client->bodyCount) break;
+
+        // Reordered packets: never go back in time
+        NetBodyView *body = &client->bodies[entry.id];
+        if (body->known && body->tick > header.tick) continue;
+
+        NetDequantizeTransform(&entry.transform, body->position, body->rotation);
+        if (entry.flags & NET_ENTRY_EXTENTS) {
+            for (int k = 0; k < 3; k++) body->halfExtents[k] = NetDequantizeExtent(entry.halfExtents[k]);
+        }
+        body->known = true;
+        body->tick = header.tick;
+        stats->entries++;
+    }
+}
+
+bool NetClientConnect(NetClient *client, const char *host, uint16_t port) {
+    memset(client, 0, sizeof(*client));
+    if (!NetInit()) return false;
+    if (!NetResolve(host, port, &client->server)) {
+        printf("Cannot resolve %s\n", host);
+        return false;
+    }
+    if (!NetSocketOpen(&client->socket, 0)) {
+        printf("Cannot open UDP socket\n");
+        return false;
+    }
+
+    // Default camera until the caller sets one: everything is relevant
+    client->camera.forward[2] = -1.0f;
+    client->camera.horizontalFov = 180.0f;
+    client->camera.viewDistance = 2.0f * NET_WORLD_EXTENT;
+    sendCamera(client, PerfNowSeconds());
+    return true;
+}
+
+void NetClientDisconnect(NetClient *client) {
+    uint8_t buffer[8];
+    NetWriter writer;
+    NetWriterInit(&writer, buffer, sizeof(buffer));
+    NetWriteBye(&writer);
+    NetSocketSend(&client->socket, &client->server, buffer, writer.size);
+
+    NetSocketClose(&client->socket);
+    NetShutdown();
+    free(client->bodies);
+    free(client->stats.latencies);
+    memset(client, 0, sizeof(*client));
+}
+
+void NetClientSetCamera(NetClient *client, const NetCameraPacket *camera) {
+    client->camera = *camera;
+    sendCamera(client, PerfNowSeconds());
+}
+
+void NetClientSendCommand(NetClient *client, NetCommand command) {
+    double now = PerfNowSeconds();
+    client->command.sequence++;
+    client->command.command = (uint8_t)command;
+    client->command.clientTime = now;
+    client->commandPending = true;
+    sendCommand(client, now);
+}
+
+void NetClientUpdate(NetClient *client) {
+    uint8_t buffer[NET_MAX_PACKET];
+    int size;
+    while ((size = NetSocketReceive(&client->socket, NULL, buffer, sizeof(buffer))) >= 0) {
+        NetReader reader;
+        NetReaderInit(&reader, buffer, size);
+        if (NetReadPacketType(&reader) == NET_PACKET_STATE) {
+            handleState(client, &reader, size, PerfNowSeconds());
+        }
+    }
+
+    double now = PerfNowSeconds();
+    if (now - client->lastCameraSend > NET_CAMERA_INTERVAL) sendCamera(client, now);
+    if (client->commandPending && now - client->lastCommandSend > NET_COMMAND_RESEND) sendCommand(client, now);
+}
+
+static int compareFloats(const void *a, const void *b) {
+    float fa = *(const float *)a;
+    float fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+float NetClientLatencyPercentile(const NetClient *client, float percentile) {
+    int count = client->stats.latencyCount;
+    if (count == 0) return 0.0f;
+
+    float *sorted = (float *)malloc(sizeof(float) * (size_t)count);
+    memcpy(sorted, client->stats.latencies, sizeof(float) * (size_t)count);
+    qsort(sorted, (size_t)count, sizeof(float), compareFloats);
+    int index = (int)(percentile / 100.0f * (float)(count - 1) + 0.5f);
+    float value = sorted[index < 0 ? 0 : (index >= count ? count - 1 : index)];
+    free(sorted);
+    return value;
+}
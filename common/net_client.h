@@ -0,0 +1,77 @@
+// Viewer side of the simulation server protocol: keeps the latest known
+// transform per body, resends camera keepalives and unacknowledged commands,
+// and collects bandwidth / latency statistics.
+#ifndef NET_CLIENT_H
+#define NET_CLIENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "net_protocol.h"
+#include "net_socket.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct NetBodyView {
+    bool known;
+    float position[3];
+    float rotation[4];      // Quaternion x, y, z, w
+    float halfExtents[3];
+    uint32_t tick;          // Server tick of the last update
+} NetBodyView;
+
+typedef struct NetClientStats {
+    uint64_t packets;
+    uint64_t bytes;
+    uint64_t entries;
+    uint32_t ticks;             // Distinct ticks received
+    uint32_t firstTick;
+    uint32_t lastTick;
+    uint32_t maxTickBytes;
+    float *latencies;           // Server step -> received, ms, one per tick
+    int latencyCount;
+    int latencyCapacity;
+    double commandRttSum;       // Command sent -> its effect received, seconds
+    double commandRttMax;
+    uint32_t commandRtts;
+} NetClientStats;
+
+typedef struct NetClient {
+    NetSocket socket;
+    NetAddress server;
+    NetBodyView *bodies;
+    int bodyCount;
+    uint32_t latestTick;
+    uint32_t tickBytes;         // Bytes received so far for latestTick
+
+    NetCameraPacket camera;
+    double lastCameraSend;
+
+    NetCommandPacket command;
+    bool commandPending;
+    double lastCommandSend;
+
+    NetClientStats stats;
+} NetClient;
+
+bool NetClientConnect(NetClient *client, const char *host, uint16_t port);
+void NetClientDisconnect(NetClient *client);
+
+// Sent right away, then periodically as the keepalive
+void NetClientSetCamera(NetClient *client, const NetCameraPacket *camera);
+// Replaces any unacknowledged command, resent until the server acks it
+void NetClientSendCommand(NetClient *client, NetCommand command);
+
+// Drains the socket and handles resends, call once per frame
+void NetClientUpdate(NetClient *client);
+
+// Latency percentile (0..100) over all ticks received, in ms
+float NetClientLatencyPercentile(const NetClient *client, float percentile);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // NET_CLIENT_H
@@ -0,0 +1,239 @@
+#include "net_protocol.h"
+
+#include <math.h>
+#include <string.h>
+
+#define SQRT2 1.41421356f
+
+void NetWriterInit(NetWriter *writer, uint8_t *buffer, int capacity) {
+    writer->data = buffer;
+    writer->size = 0;
+    writer->capacity = capacity;
+    writer->overflow = false;
+}
+
+static void writeBytes(NetWriter *writer, uint64_t value, int count) {
+    if (writer->size + count > writer->capacity) {
+        writer->overflow = true;
+        return;
+    }
+    for (int i = 0; i < count; i++) writer->data[writer->size++] = (uint8_t)(value >> (8 * i));
+}
+
+void NetWriteU8(NetWriter *writer, uint8_t value) { writeBytes(writer, value, 1); }
+void NetWriteU16(NetWriter *writer, uint16_t value) { writeBytes(writer, value, 2); }
+void NetWriteU32(NetWriter *writer, uint32_t value) { writeBytes(writer, value, 4); }
+
+void NetWriteF32(NetWriter *writer, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeBytes(writer, bits, 4);
+}
+
+void NetWriteF64(NetWriter *writer, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeBytes(writer, bits, 8);
+}
+
+void NetPatchU16(NetWriter *writer, int offset, uint16_t value) {
+    if (offset + 2 > writer->size) return;
+    writer->data[offset] = (uint8_t)value;
+    writer->data[offset + 1] = (uint8_t)(value >> 8);
+}
+
+void NetReaderInit(NetReader *reader, const uint8_t *data, int size) {
+    reader->data = data;
+    reader->size = size;
+    reader->position = 0;
+    reader->failed = false;
+}
+
+static uint64_t readBytes(NetReader *reader, int count) {
+    if (reader->position + count > reader->size) {
+        reader->failed = true;
+        return 0;
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < count; i++) value |= (uint64_t)reader->data[reader->position++] << (8 * i);
+    return value;
+}
+
+uint8_t NetReadU8(NetReader *reader) { return (uint8_t)readBytes(reader, 1); }
+uint16_t NetReadU16(NetReader *reader) { return (uint16_t)readBytes(reader, 2); }
+uint32_t NetReadU32(NetReader *reader) { return (uint32_t)readBytes(reader, 4); }
+
+float NetReadF32(NetReader *reader) {
+    uint32_t bits = (uint32_t)readBytes(reader, 4);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double NetReadF64(NetReader *reader) {
+    uint64_t bits = readBytes(reader, 8);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static uint16_t quantizePosition(float value) {
+    float t = (value + NET_WORLD_EXTENT) / (2.0f * NET_WORLD_EXTENT);
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    return (uint16_t)lrintf(t * 65535.0f);
+}
+
+static float dequantizePosition(uint16_t value) {
+    return (float)value / 65535.0f * (2.0f * NET_WORLD_EXTENT) - NET_WORLD_EXTENT;
+}
+
+void NetQuantizeTransform(const BodyState *state, NetQuantizedTransform *out) {
+    for (int i = 0; i < 3; i++) out->position[i] = quantizePosition(state->position[i]);
+
+    // Smallest three: drop the largest component (sign folded so it is positive),
+    // the other three are then within +-1/sqrt(2)
+    const float *q = state->rotation;
+    float length = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    if (length <= 0.0f) length = 1.0f;
+
+    int largest = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(q[i]) > fabsf(q[largest])) largest = i;
+    }
+    float scale = (q[largest] < 0.0f ? -1.0f : 1.0f) / length;
+
+    uint32_t packed = (uint32_t)largest << 30;
+    int shift = 20;
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) continue;
+        float v = q[i] * scale * SQRT2;
+        if (v < -1.0f) v = -1.0f;
+        if (v > 1.0f) v = 1.0f;
+        packed |= (uint32_t)lrintf((v * 0.5f + 0.5f) * 1023.0f) << shift;
+        shift -= 10;
+    }
+    out->rotation = packed;
+}
+
+void NetDequantizeTransform(const NetQuantizedTransform *in, float position[3], float rotation[4]) {
+    for (int i = 0; i < 3; i++) position[i] = dequantizePosition(in->position[i]);
+
+    int largest = (int)(in->rotation >> 30);
+    int shift = 20;
+    float sum = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) continue;
+        uint32_t bits = (in->rotation >> shift) & 1023u;
+        float v = ((float)bits / 1023.0f * 2.0f - 1.0f) / SQRT2;
+        rotation[i] = v;
+        sum += v * v;
+        shift -= 10;
+    }
+    rotation[largest] = sqrtf(fmaxf(0.0f, 1.0f - sum));
+}
+
+uint16_t NetQuantizeExtent(float halfExtent) {
+    float v = halfExtent * 256.0f;
+    if (v < 0.0f) v = 0.0f;
+    if (v > 65535.0f) v = 65535.0f;
+    return (uint16_t)lrintf(v);
+}
+
+float NetDequantizeExtent(uint16_t value) {
+    return (float)value / 256.0f;
+}
+
+float NetHorizontalFov(float fovyDegrees, float aspect) {
+    const float toRadians = 3.14159265f / 180.0f;
+    return 2.0f * atanf(tanf(fovyDegrees * 0.5f * toRadians) * aspect) / toRadians;
+}
+
+int NetReadPacketType(NetReader *reader) {
+    uint16_t magic = NetReadU16(reader);
+    uint8_t type = NetReadU8(reader);
+    if (reader->failed || magic != NET_MAGIC) return 0;
+    return type;
+}
+
+static void writePacketType(NetWriter *writer, NetPacketType type) {
+    NetWriteU16(writer, NET_MAGIC);
+    NetWriteU8(writer, (uint8_t)type);
+}
+
+void NetWriteCamera(NetWriter *writer, const NetCameraPacket *packet) {
+    writePacketType(writer, NET_PACKET_CAMERA);
+    for (int i = 0; i < 3; i++) NetWriteF32(writer, packet->position[i]);
+    for (int i = 0; i < 3; i++) NetWriteF32(writer, packet->forward[i]);
+    NetWriteF32(writer, packet->horizontalFov);
+    NetWriteF32(writer, packet->viewDistance);
+    NetWriteU32(writer, packet->budget);
+}
+
+bool NetReadCamera(NetReader *reader, NetCameraPacket *packet) {
+    for (int i = 0; i < 3; i++) packet->position[i] = NetReadF32(reader);
+    for (int i = 0; i < 3; i++) packet->forward[i] = NetReadF32(reader);
+    packet->horizontalFov = NetReadF32(reader);
+    packet->viewDistance = NetReadF32(reader);
+    packet->budget = NetReadU32(reader);
+    return !reader->failed;
+}
+
+void NetWriteCommand(NetWriter *writer, const NetCommandPacket *packet) {
+    writePacketType(writer, NET_PACKET_COMMAND);
+    NetWriteU32(writer, packet->sequence);
+    NetWriteU8(writer, packet->command);
+    NetWriteF64(writer, packet->clientTime);
+}
+
+bool NetReadCommand(NetReader *reader, NetCommandPacket *packet) {
+    packet->sequence = NetReadU32(reader);
+    packet->command = NetReadU8(reader);
+    packet->clientTime = NetReadF64(reader);
+    return !reader->failed;
+}
+
+void NetWriteBye(NetWriter *writer) {
+    writePacketType(writer, NET_PACKET_BYE);
+}
+
+void NetWriteStateHeader(NetWriter *writer, const NetStateHeader *header) {
+    writePacketType(writer, NET_PACKET_STATE);
+    NetWriteU32(writer, header->tick);
+    NetWriteF64(writer, header->serverTime);
+    NetWriteU32(writer, header->commandAck);
+    NetWriteF64(writer, header->commandEchoTime);
+    NetWriteU16(writer, header->bodyCount);
+    NetWriteU16(writer, header->entryCount);
+}
+
+bool NetReadStateHeader(NetReader *reader, NetStateHeader *header) {
+    header->tick = NetReadU32(reader);
+    header->serverTime = NetReadF64(reader);
+    header->commandAck = NetReadU32(reader);
+    header->commandEchoTime = NetReadF64(reader);
+    header->bodyCount = NetReadU16(reader);
+    header->entryCount = NetReadU16(reader);
+    return !reader->failed;
+}
+
+void NetWriteStateEntry(NetWriter *writer, const NetStateEntry *entry) {
+    NetWriteU16(writer, entry->id);
+    NetWriteU8(writer, entry->flags);
+    for (int i = 0; i < 3; i++) NetWriteU16(writer, entry->transform.position[i]);
+    NetWriteU32(writer, entry->transform.rotation);
+    if (entry->flags & NET_ENTRY_EXTENTS) {
+        for (int i = 0; i < 3; i++) NetWriteU16(writer, entry->halfExtents[i]);
+    }
+}
+
+bool NetReadStateEntry(NetReader *reader, NetStateEntry *entry) {
+    entry->id = NetReadU16(reader);
+    entry->flags = NetReadU8(reader);
+    for (int i = 0; i < 3; i++) entry->transform.position[i] = NetReadU16(reader);
+    entry->transform.rotation = NetReadU32(reader);
+    if (entry->flags & NET_ENTRY_EXTENTS) {
+        for (int i = 0; i < 3; i++) entry->halfExtents[i] = NetReadU16(reader);
+    }
+    return !reader->failed;
+}
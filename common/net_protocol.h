@@ -0,0 +1,140 @@
+// Wire format between the headless simulation server and its viewers.
+//
+// Everything is little endian and written field by field, no struct packing.
+// Client -> server: CAMERA (also the keepalive), COMMAND, BYE.
+// Server -> client: STATE, a header plus the bodies that changed since they
+// were last sent to that client, with quantized transforms:
+//   position  3 x 16 bit over [-NET_WORLD_EXTENT, NET_WORLD_EXTENT] (~1.6 cm)
+//   rotation  smallest-three quaternion, 2 bit index + 3 x 10 bit
+#ifndef NET_PROTOCOL_H
+#define NET_PROTOCOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "body_state.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define NET_DEFAULT_PORT 27015
+#define NET_MAX_PACKET 1200         // Fits a typical MTU with IP/UDP headers
+#define NET_MAGIC 0x5043
+#define NET_WORLD_EXTENT 512.0f
+#define NET_MAX_BODIES 65535
+#define NET_FOV_MARGIN 10.0f        // Degrees added around the view cone, covers the frustum corners
+#define NET_REFRESH_TICKS 120       // Unchanged bodies in interest are resent this often, covers lost packets
+
+#define NET_STATE_HEADER_SIZE 31
+#define NET_ENTRY_SIZE 13
+#define NET_ENTRY_EXTENTS_SIZE 6
+#define NET_ENTRY_EXTENTS 0x01      // Entry carries half extents (first send, refreshes)
+
+typedef enum NetPacketType {
+    NET_PACKET_CAMERA = 1,
+    NET_PACKET_COMMAND,
+    NET_PACKET_BYE,
+    NET_PACKET_STATE
+} NetPacketType;
+
+// The demos' existing keyboard actions
+typedef enum NetCommand {
+    NET_COMMAND_RESET = 1,
+    NET_COMMAND_RANDOMIZE
+} NetCommand;
+
+typedef struct NetWriter {
+    uint8_t *data;
+    int size;
+    int capacity;
+    bool overflow;
+} NetWriter;
+
+typedef struct NetReader {
+    const uint8_t *data;
+    int size;
+    int position;
+    bool failed;
+} NetReader;
+
+typedef struct NetQuantizedTransform {
+    uint16_t position[3];
+    uint32_t rotation;
+} NetQuantizedTransform;
+
+// Interest and bandwidth settings of one viewer
+typedef struct NetCameraPacket {
+    float position[3];
+    float forward[3];       // Unit length
+    float horizontalFov;    // Full horizontal field of view in degrees (NetHorizontalFov), 180+ = no cone
+    float viewDistance;
+    uint32_t budget;        // Bytes per tick, 0 = server default, raised to NET_MAX_PACKET by the server
+} NetCameraPacket;
+
+typedef struct NetCommandPacket {
+    uint32_t sequence;      // Increasing, the server applies each sequence once
+    uint8_t command;        // NetCommand
+    double clientTime;      // Echoed back for round trip timing
+} NetCommandPacket;
+
+typedef struct NetStateHeader {
+    uint32_t tick;
+    double serverTime;      // PerfNowSeconds() after the step, comparable on the same host only
+    uint32_t commandAck;    // Last command sequence applied for this client
+    double commandEchoTime; // Its clientTime
+    uint16_t bodyCount;     // Bodies in the scene
+    uint16_t entryCount;    // Entries in this packet
+} NetStateHeader;
+
+typedef struct NetStateEntry {
+    uint16_t id;
+    uint8_t flags;
+    NetQuantizedTransform transform;
+    uint16_t halfExtents[3];    // 1/256 m units, valid with NET_ENTRY_EXTENTS
+} NetStateEntry;
+
+void NetWriterInit(NetWriter *writer, uint8_t *buffer, int capacity);
+void NetWriteU8(NetWriter *writer, uint8_t value);
+void NetWriteU16(NetWriter *writer, uint16_t value);
+void NetWriteU32(NetWriter *writer, uint32_t value);
+void NetWriteF32(NetWriter *writer, float value);
+void NetWriteF64(NetWriter *writer, double value);
+// Overwrites a u16 written earlier (counts known only after the payload)
+void NetPatchU16(NetWriter *writer, int offset, uint16_t value);
+
+void NetReaderInit(NetReader *reader, const uint8_t *data, int size);
+uint8_t NetReadU8(NetReader *reader);
+uint16_t NetReadU16(NetReader *reader);
+uint32_t NetReadU32(NetReader *reader);
+float NetReadF32(NetReader *reader);
+double NetReadF64(NetReader *reader);
+
+void NetQuantizeTransform(const BodyState *state, NetQuantizedTransform *out);
+void NetDequantizeTransform(const NetQuantizedTransform *in, float position[3], float rotation[4]);
+uint16_t NetQuantizeExtent(float halfExtent);
+
+// Full horizontal field of view of a camera with raylib's vertical fovy, all in degrees
+float NetHorizontalFov(float fovyDegrees, float aspect);
+float NetDequantizeExtent(uint16_t value);
+
+// Reads magic + type, returns 0 for foreign or truncated datagrams
+int NetReadPacketType(NetReader *reader);
+
+void NetWriteCamera(NetWriter *writer, const NetCameraPacket *packet);
+bool NetReadCamera(NetReader *reader, NetCameraPacket *packet);
+void NetWriteCommand(NetWriter *writer, const NetCommandPacket *packet);
+bool NetReadCommand(NetReader *reader, NetCommandPacket *packet);
+void NetWriteBye(NetWriter *writer);
+
+// entryCount sits in the last two header bytes, patch it with NetPatchU16 once entries are written
+void NetWriteStateHeader(NetWriter *writer, const NetStateHeader *header);
+bool NetReadStateHeader(NetReader *reader, NetStateHeader *header);
+void NetWriteStateEntry(NetWriter *writer, const NetStateEntry *entry);
+bool NetReadStateEntry(NetReader *reader, NetStateEntry *entry);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // NET_PROTOCOL_H
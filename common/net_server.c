@@ -0,0 +1,347 @@
+#include "net_server.h"
+
+#include <math.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "net_protocol.h"
+#include "net_socket.h"
+#include "perf_timer.h"
+
+#define NET_MAX_CLIENTS 16
+#define NET_CLIENT_TIMEOUT 5.0      // Seconds without a camera/command packet
+#define NET_NEAR_RADIUS 8.0f        // Relevant whatever the camera direction
+#define NET_STATS_INTERVAL 5.0
+
+typedef struct NetClientSlot {
+    bool active;
+    NetAddress address;
+    double lastHeard;
+    NetCameraPacket camera;
+    float cosHalfAngle;
+    uint32_t commandAck;
+    double commandEchoTime;
+
+    // Per body
+    float *priority;
+    uint32_t *lastSentTick;         // 0 = never sent
+    NetQuantizedTransform *lastSent;
+} NetClientSlot;
+
+typedef struct NetCandidate {
+    float priority;
+    uint16_t id;
+} NetCandidate;
+
+typedef struct NetServer {
+    NetServerConfig config;
+    NetSocket socket;
+    NetClientSlot clients[NET_MAX_CLIENTS];
+    BodyState *states;
+    NetQuantizedTransform *quantized;
+    NetCandidate *candidates;
+    uint32_t tick;
+
+    double statsStart;
+    double statsStepSeconds;
+    uint64_t statsBytes;
+    uint64_t statsEntries;
+    uint32_t statsTicks;
+    uint32_t statsClientTicks;
+} NetServer;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int signalNumber) {
+    (void)signalNumber;
+    stopRequested = 1;
+}
+
+static void releaseClient(NetClientSlot *client) {
+    free(client->priority);
+    free(client->lastSentTick);
+    free(client->lastSent);
+    memset(client, 0, sizeof(*client));
+}
+
+static NetClientSlot *findClient(NetServer *server, const NetAddress *address, bool create, double now) {
+    NetClientSlot *freeSlot = NULL;
+    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
+        NetClientSlot *client = &server->clients[i];
+        if (client->active && NetAddressEqual(&client->address, address)) return client;
+        if (!client->active && !freeSlot) freeSlot = client;
+    }
+    if (!create || !freeSlot) return NULL;
+
+    int count = server->config.bodyCount;
+    freeSlot->priority = (float *)calloc((size_t)count, sizeof(float));
+    freeSlot->lastSentTick = (uint32_t *)calloc((size_t)count, sizeof(uint32_t));
+    freeSlot->lastSent = (NetQuantizedTransform *)calloc((size_t)count, sizeof(NetQuantizedTransform));
+    if (!freeSlot->priority || !freeSlot->lastSentTick || !freeSlot->lastSent) {
+        printf("Server: out of memory for a viewer\n");
+        releaseClient(freeSlot);
+        return NULL;
+    }
+    freeSlot->active = true;
+    freeSlot->address = *address;
+    freeSlot->lastHeard = now;
+    // Sees everything until its first camera packet arrives
+    freeSlot->camera.viewDistance = 2.0f * NET_WORLD_EXTENT;
+    freeSlot->camera.forward[2] = -1.0f;
+    freeSlot->cosHalfAngle = -1.0f;
+    printf("Viewer connected: %u.%u.%u.%u:%u\n", address->ip >> 24, (address->ip >> 16) & 255,
+           (address->ip >> 8) & 255, address->ip & 255, address->port);
+    return freeSlot;
+}
+
+static void setCamera(NetClientSlot *client, const NetCameraPacket *camera) {
+    client->camera = *camera;
+    // Same floor as --budget: below one full packet a viewer would only ever get empty headers
+    if (camera->budget != 0 && camera->budget < NET_MAX_PACKET) client->camera.budget = NET_MAX_PACKET;
+    float halfAngle = camera->horizontalFov * 0.5f + NET_FOV_MARGIN;
+    if (camera->horizontalFov >= 180.0f || halfAngle >= 180.0f) {
+        client->cosHalfAngle = -1.0f;   // No cone, distance only
+        return;
+    }
+    client->cosHalfAngle = cosf(halfAngle * 3.14159265f / 180.0f);
+}
+
+static void pollPackets(NetServer *server, const NetServerCallbacks *callbacks, double now) {
+    uint8_t buffer[NET_MAX_PACKET];
+    NetAddress from;
+    int size;
+    while ((size = NetSocketReceive(&server->socket, &from, buffer, sizeof(buffer))) >= 0) {
+        NetReader reader;
+        NetReaderInit(&reader, buffer, size);
+        int type = NetReadPacketType(&reader);
+
+        if (type == NET_PACKET_CAMERA) {
+            NetCameraPacket camera;
+            NetClientSlot *client = findClient(server, &from, true, now);
+            if (client && NetReadCamera(&reader, &camera)) {
+                setCamera(client, &camera);
+                client->lastHeard = now;
+            }
+        } else if (type == NET_PACKET_COMMAND) {
+            NetCommandPacket command;
+            NetClientSlot *client = findClient(server, &from, true, now);
+            if (client && NetReadCommand(&reader, &command)) {
+                client->lastHeard = now;
+                // Clients resend until acked, apply each sequence once
+                if (command.sequence > client->commandAck) {
+                    callbacks->command(callbacks->user, command.command);
+                    client->commandAck = command.sequence;
+                    client->commandEchoTime = command.clientTime;
+                }
+            }
+        } else if (type == NET_PACKET_BYE) {
+            NetClientSlot *client = findClient(server, &from, false, now);
+            if (client) {
+                printf("Viewer disconnected\n");
+                releaseClient(client);
+            }
+        }
+    }
+}
+
+static int compareCandidates(const void *a, const void *b) {
+    float pa = ((const NetCandidate *)a)->priority;
+    float pb = ((const NetCandidate *)b)->priority;
+    return (pa < pb) - (pa > pb);
+}
+
+// Scores this tick's candidates for one client, returns how many there are
+static int gatherCandidates(NetServer *server, NetClientSlot *client) {
+    const NetCameraPacket *camera = &client->camera;
+    float viewDistanceSq = camera->viewDistance * camera->viewDistance;
+    int count = 0;
+
+    for (int i = 0; i < server->config.bodyCount; i++) {
+        const float *p = server->states[i].position;
+        float d[3] = { p[0] - camera->position[0], p[1] - camera->position[1], p[2] - camera->position[2] };
+        float distanceSq = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        if (distanceSq > viewDistanceSq) continue;
+
+        float distance = sqrtf(distanceSq);
+        if (distance > NET_NEAR_RADIUS) {
+            float along = d[0] * camera->forward[0] + d[1] * camera->forward[1] + d[2] * camera->forward[2];
+            if (along < client->cosHalfAngle * distance) continue;
+        }
+
+        const NetQuantizedTransform *q = &server->quantized[i];
+        bool neverSent = client->lastSentTick[i] == 0;
+        const NetQuantizedTransform *sent = &client->lastSent[i];
+        bool changed = neverSent || q->rotation != sent->rotation || q->position[0] != sent->position[0]
+                    || q->position[1] != sent->position[1] || q->position[2] != sent->position[2];
+        bool stale = server->tick - client->lastSentTick[i] >= NET_REFRESH_TICKS;
+        if (!changed && !stale) continue;
+
+        // Starved bodies keep accumulating until they win a slot
+        float weight = 1.0f / (1.0f + distance * 0.1f);
+        client->priority[i] += changed ? weight : 0.25f * weight;
+        server->candidates[count].priority = client->priority[i];
+        server->candidates[count].id = (uint16_t)i;
+        count++;
+    }
+    return count;
+}
+
+static void sendClientState(NetServer *server, NetClientSlot *client, double now) {
+    int candidateCount = gatherCandidates(server, client);
+    qsort(server->candidates, (size_t)candidateCount, sizeof(NetCandidate), compareCandidates);
+
+    uint32_t budget = client->camera.budget ? client->camera.budget : server->config.defaultBudget;
+    uint32_t spent = 0;
+    int next = 0;
+
+    NetStateHeader header;
+    header.tick = server->tick;
+    header.serverTime = now;
+    header.commandAck = client->commandAck;
+    header.commandEchoTime = client->commandEchoTime;
+    header.bodyCount = (uint16_t)server->config.bodyCount;
+    header.entryCount = 0;
+
+    // At least one (possibly empty) packet per tick: carries the tick, timing and command ack
+    for (int packet = 0; packet == 0 || next < candidateCount; packet++) {
+        uint8_t buffer[NET_MAX_PACKET];
+        NetWriter writer;
+        NetWriterInit(&writer, buffer, sizeof(buffer));
+        NetWriteStateHeader(&writer, &header);
+
+        uint16_t entries = 0;
+        while (next < candidateCount) {
+            uint16_t id = server->candidates[next].id;
+            bool extents = client->lastSentTick[id] == 0 || server->tick - client->lastSentTick[id] >= NET_REFRESH_TICKS;
+            int entrySize = NET_ENTRY_SIZE + (extents ? NET_ENTRY_EXTENTS_SIZE : 0);
+            if (writer.size + entrySize > writer.capacity || spent + (uint32_t)(writer.size + entrySize) > budget) break;
+
+            NetStateEntry entry;
+            entry.id = id;
+            entry.flags = extents ? NET_ENTRY_EXTENTS : 0;
+            entry.transform = server->quantized[id];
+            for (int k = 0; k < 3; k++) entry.halfExtents[k] = NetQuantizeExtent(server->states[id].halfExtents[k]);
+            NetWriteStateEntry(&writer, &entry);
+
+            client->lastSent[id] = entry.transform;
+            client->lastSentTick[id] = server->tick;
+            client->priority[id] = 0.0f;
+            entries++;
+            next++;
+        }
+
+        if (entries == 0 && packet > 0) break;  // Budget spent
+
+        NetPatchU16(&writer, NET_STATE_HEADER_SIZE - 2, entries);
+        NetSocketSend(&server->socket, &client->address, buffer, writer.size);
+        spent += (uint32_t)writer.size;
+        server->statsEntries += entries;
+        if (entries == 0) break;
+    }
+
+    server->statsBytes += spent;
+    server->statsClientTicks++;
+}
+
+static void reportStats(NetServer *server, double now) {
+    if (now - server->statsStart < NET_STATS_INTERVAL) return;
+
+    int clients = 0;
+    for (int i = 0; i < NET_MAX_CLIENTS; i++) clients += server->clients[i].active;
+    double ticks = server->statsTicks ? (double)server->statsTicks : 1.0;
+    double clientTicks = server->statsClientTicks ? (double)server->statsClientTicks : 1.0;
+    printf("tick %u: %d viewers, step %.3f ms, %.0f bytes/tick/viewer, %.1f bodies/tick/viewer\n",
+           server->tick, clients, server->statsStepSeconds / ticks * 1000.0,
+           (double)server->statsBytes / clientTicks, (double)server->statsEntries / clientTicks);
+
+    server->statsStart = now;
+    server->statsStepSeconds = 0.0;
+    server->statsBytes = 0;
+    server->statsEntries = 0;
+    server->statsTicks = 0;
+    server->statsClientTicks = 0;
+}
+
+int RunNetServer(const NetServerConfig *config, const NetServerCallbacks *callbacks) {
+    NetServer server;
+    memset(&server, 0, sizeof(server));
+    server.config = *config;
+    if (server.config.bodyCount > NET_MAX_BODIES) server.config.bodyCount = NET_MAX_BODIES;
+    if (server.config.tickRate <= 0.0f) server.config.tickRate = 60.0f;
+    if (server.config.defaultBudget == 0) server.config.defaultBudget = NET_DEFAULT_BUDGET;
+
+    if (!NetInit() || !NetSocketOpen(&server.socket, server.config.port)) {
+        printf("Server: cannot open UDP port %u\n", server.config.port);
+        return 1;
+    }
+
+    int count = server.config.bodyCount;
+    server.states = (BodyState *)calloc((size_t)count, sizeof(BodyState));
+    server.quantized = (NetQuantizedTransform *)calloc((size_t)count, sizeof(NetQuantizedTransform));
+    server.candidates = (NetCandidate *)calloc((size_t)count, sizeof(NetCandidate));
+    if (!server.states || !server.quantized || !server.candidates) {
+        printf("Server: out of memory for %d bodies\n", count);
+        free(server.states);
+        free(server.quantized);
+        free(server.candidates);
+        NetSocketClose(&server.socket);
+        NetShutdown();
+        return 1;
+    }
+
+    signal(SIGINT, onSignal);
+    PerfBeginSleepResolution();     // No window, raylib never raised it
+    printf("Server: %d bodies at %.0f Hz on UDP port %u, %u bytes/tick per viewer (Ctrl+C to stop)\n",
+           count, server.config.tickRate, server.config.port, server.config.defaultBudget);
+
+    const double dt = 1.0 / server.config.tickRate;
+    double nextTick = PerfNowSeconds();
+    server.statsStart = nextTick;
+
+    while (!stopRequested) {
+        pollPackets(&server, callbacks, PerfNowSeconds());
+
+        double stepStart = PerfNowSeconds();
+        callbacks->step(callbacks->user, (float)dt);
+        callbacks->gather(callbacks->user, server.states, count);
+        double now = PerfNowSeconds();
+        server.statsStepSeconds += now - stepStart;
+        server.statsTicks++;
+        server.tick++;
+
+        for (int i = 0; i < count; i++) NetQuantizeTransform(&server.states[i], &server.quantized[i]);
+
+        for (int i = 0; i < NET_MAX_CLIENTS; i++) {
+            NetClientSlot *client = &server.clients[i];
+            if (!client->active) continue;
+            if (now - client->lastHeard > NET_CLIENT_TIMEOUT) {
+                printf("Viewer timed out\n");
+                releaseClient(client);
+                continue;
+            }
+            sendClientState(&server, client, now);
+        }
+
+        reportStats(&server, now);
+
+        // Fell far behind (debugger, overload): resync instead of bursting to catch up
+        nextTick += dt;
+        if (PerfNowSeconds() - nextTick > 5.0 * dt) nextTick = PerfNowSeconds();
+        PerfSleepUntil(nextTick);
+    }
+
+    printf("Server: stopping after %u ticks\n", server.tick);
+    PerfEndSleepResolution();
+    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
+        if (server.clients[i].active) releaseClient(&server.clients[i]);
+    }
+    free(server.states);
+    free(server.quantized);
+    free(server.candidates);
+    NetSocketClose(&server.socket);
+    NetShutdown();
+    return 0;
+}
@@ -0,0 +1,45 @@
+// Headless authoritative simulation server.
+//
+// Steps the demo's engine at a fixed rate and streams per-client state deltas
+// over UDP (see net_protocol.h). For every viewer it keeps the last transform
+// it was sent per body, and each tick only bodies that
+//   - are inside the viewer's interest area (near radius, or camera cone within view distance),
+//   - changed since last sent, or were not refreshed for NET_REFRESH_TICKS,
+// are candidates. Candidates accumulate priority (closer = faster) until sent,
+// and are packed highest priority first until the viewer's byte budget for the tick is spent.
+#ifndef NET_SERVER_H
+#define NET_SERVER_H
+
+#include <stdint.h>
+
+#include "body_state.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define NET_DEFAULT_BUDGET 4096     // Bytes per tick per viewer
+
+typedef struct NetServerConfig {
+    uint16_t port;
+    float tickRate;             // Steps per second
+    uint32_t defaultBudget;     // Bytes per tick for viewers that do not ask for one
+    int bodyCount;              // Fixed for the server lifetime, at most NET_MAX_BODIES
+} NetServerConfig;
+
+// Engine glue, called from the server loop on the calling thread
+typedef struct NetServerCallbacks {
+    void *user;
+    void (*step)(void *user, float dt);
+    void (*gather)(void *user, BodyState *states, int count);
+    void (*command)(void *user, int command);   // NetCommand, applied before the next step
+} NetServerCallbacks;
+
+// Runs until Ctrl+C. Returns non-zero when the socket cannot be opened.
+int RunNetServer(const NetServerConfig *config, const NetServerCallbacks *callbacks);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // NET_SERVER_H
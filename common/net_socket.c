@@ -0,0 +1,128 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "net_socket.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#define INVALID_HANDLE ((intptr_t)INVALID_SOCKET)
+#define SOCK(s) ((SOCKET)(s))
+#define closeSocket(s) closesocket(SOCK(s))
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define INVALID_HANDLE ((intptr_t)-1)
+#define SOCK(s) ((int)(s))
+#define closeSocket(s) close(SOCK(s))
+#endif
+
+static void toSockaddr(const NetAddress *address, struct sockaddr_in *out) {
+    memset(out, 0, sizeof(*out));
+    out->sin_family = AF_INET;
+    out->sin_addr.s_addr = htonl(address->ip);
+    out->sin_port = htons(address->port);
+}
+
+bool NetInit(void) {
+#if defined(_WIN32)
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+    return true;
+#endif
+}
+
+void NetShutdown(void) {
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+bool NetSocketOpen(NetSocket *sock, uint16_t port) {
+    sock->handle = (intptr_t)socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock->handle == INVALID_HANDLE) return false;
+
+    // Room for a few ticks of state when the reader stalls
+    int bufferSize = 1 << 20;
+    setsockopt(SOCK(sock->handle), SOL_SOCKET, SO_RCVBUF, (const char *)&bufferSize, sizeof(bufferSize));
+    setsockopt(SOCK(sock->handle), SOL_SOCKET, SO_SNDBUF, (const char *)&bufferSize, sizeof(bufferSize));
+
+    struct sockaddr_in local;
+    NetAddress any = { 0, port };
+    toSockaddr(&any, &local);
+    if (bind(SOCK(sock->handle), (struct sockaddr *)&local, sizeof(local)) != 0) {
+        NetSocketClose(sock);
+        return false;
+    }
+
+#if defined(_WIN32)
+    u_long nonBlocking = 1;
+    ioctlsocket(SOCK(sock->handle), FIONBIO, &nonBlocking);
+#else
+    fcntl(SOCK(sock->handle), F_SETFL, fcntl(SOCK(sock->handle), F_GETFL, 0) | O_NONBLOCK);
+#endif
+    return true;
+}
+
+void NetSocketClose(NetSocket *sock) {
+    if (sock->handle != INVALID_HANDLE) closeSocket(sock->handle);
+    sock->handle = INVALID_HANDLE;
+}
+
+bool NetSocketSend(NetSocket *sock, const NetAddress *to, const void *data, int size) {
+    struct sockaddr_in remote;
+    toSockaddr(to, &remote);
+    return sendto(SOCK(sock->handle), (const char *)data, size, 0, (struct sockaddr *)&remote, sizeof(remote)) == size;
+}
+
+int NetSocketReceive(NetSocket *sock, NetAddress *from, void *buffer, int capacity) {
+    struct sockaddr_in remote;
+    socklen_t length = sizeof(remote);
+    int received = (int)recvfrom(SOCK(sock->handle), (char *)buffer, capacity, 0, (struct sockaddr *)&remote, &length);
+    if (received < 0) return -1;
+    if (from) {
+        from->ip = ntohl(remote.sin_addr.s_addr);
+        from->port = ntohs(remote.sin_port);
+    }
+    return received;
+}
+
+bool NetSocketWait(NetSocket *sock, double timeoutSeconds) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(SOCK(sock->handle), &readable);
+    struct timeval timeout;
+    if (timeoutSeconds < 0.0) timeoutSeconds = 0.0;
+    timeout.tv_sec = (long)timeoutSeconds;
+    timeout.tv_usec = (long)((timeoutSeconds - (double)timeout.tv_sec) * 1e6);
+    // The first argument is ignored by Winsock
+    return select(SOCK(sock->handle) + 1, &readable, NULL, NULL, &timeout) > 0;
+}
+
+bool NetResolve(const char *host, uint16_t port, NetAddress *out) {
+    struct addrinfo hints;
+    struct addrinfo *result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(host, NULL, &hints, &result) != 0 || !result) return false;
+
+    out->ip = ntohl(((struct sockaddr_in *)result->ai_addr)->sin_addr.s_addr);
+    out->port = port;
+    freeaddrinfo(result);
+    return true;
+}
+
+bool NetAddressEqual(const NetAddress *a, const NetAddress *b) {
+    return a->ip == b->ip && a->port == b->port;
+}
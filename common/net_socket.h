@@ -0,0 +1,43 @@
+// Minimal non-blocking IPv4 UDP sockets over Winsock / BSD sockets.
+#ifndef NET_SOCKET_H
+#define NET_SOCKET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct NetAddress {
+    uint32_t ip;        // Host byte order
+    uint16_t port;
+} NetAddress;
+
+typedef struct NetSocket {
+    intptr_t handle;
+} NetSocket;
+
+// WSAStartup on Windows, no-op elsewhere
+bool NetInit(void);
+void NetShutdown(void);
+
+// Binds to port on all interfaces, 0 picks an ephemeral port
+bool NetSocketOpen(NetSocket *sock, uint16_t port);
+void NetSocketClose(NetSocket *sock);
+
+bool NetSocketSend(NetSocket *sock, const NetAddress *to, const void *data, int size);
+// Returns the datagram size, or -1 when nothing is pending
+int NetSocketReceive(NetSocket *sock, NetAddress *from, void *buffer, int capacity);
+// Blocks until a datagram is pending or timeoutSeconds pass, true when one is
+bool NetSocketWait(NetSocket *sock, double timeoutSeconds);
+
+// IPv4 lookup of host name or dotted address
+bool NetResolve(const char *host, uint16_t port, NetAddress *out);
+bool NetAddressEqual(const NetAddress *a, const NetAddress *b);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // NET_SOCKET_H
@@ -0,0 +1,62 @@
+#include "perf_timer.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <mmsystem.h>
+
+double PerfNowSeconds(void) {
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+static void sleepSeconds(double seconds) {
+    Sleep((DWORD)(seconds * 1000.0));
+}
+
+void PerfBeginSleepResolution(void) {
+    timeBeginPeriod(1);
+}
+
+void PerfEndSleepResolution(void) {
+    timeEndPeriod(1);
+}
+#else
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include <time.h>
+
+double PerfNowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void sleepSeconds(double seconds) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+}
+
+void PerfBeginSleepResolution(void) {
+}
+
+void PerfEndSleepResolution(void) {
+}
+#endif
+
+void PerfSleepSeconds(double seconds) {
+    if (seconds > 0.0) sleepSeconds(seconds);
+}
+
+void PerfSleepUntil(double targetSeconds) {
+    double remaining = targetSeconds - PerfNowSeconds();
+    if (remaining > 0.002) sleepSeconds(remaining - 0.001);
+    while (PerfNowSeconds() < targetSeconds) {
+    }
+}
@@ -0,0 +1,29 @@
+// Monotonic high resolution clock shared by the demos.
+// Kept out of line so windows.h never ends up next to raylib.h.
+#ifndef PERF_TIMER_H
+#define PERF_TIMER_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Seconds since an arbitrary fixed point, monotonic
+double PerfNowSeconds(void);
+
+// Sleeps then spins for the last millisecond, OS sleep granularity is too coarse for fixed-rate ticks
+void PerfSleepUntil(double targetSeconds);
+
+// Plain OS sleep, no spinning: for pollers that must leave the CPU to others
+void PerfSleepSeconds(double seconds);
+
+// Windows sleeps in 15.6 ms steps unless the timer period is raised (InitWindow
+// does it for windowed demos); headless loops bracket themselves with these.
+// No-ops elsewhere.
+void PerfBeginSleepResolution(void);
+void PerfEndSleepResolution(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // PERF_TIMER_H
@@ -0,0 +1,362 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "shared_state.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "perf_timer.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SEGMENT_ALIGN 64            // Frames start on their own cache line
+#define READ_RETRIES 8
+
+// Sequence and latest are the only shared words both sides touch; the body
+// data in between is plain memory ordered by these fences (a seqlock).
+static uint32_t loadAcquire(const volatile uint32_t *p) {
+#if defined(_WIN32)
+    uint32_t value = *p;
+    MemoryBarrier();
+    return value;
+#else
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void storeRelease(volatile uint32_t *p, uint32_t value) {
+#if defined(_WIN32)
+    MemoryBarrier();
+    *p = value;
+#else
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+#endif
+}
+
+// Writer: the odd sequence is visible before any body write
+static void writeFence(void) {
+#if defined(_WIN32)
+    MemoryBarrier();
+#else
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+// Reader: body reads are done before the sequence is checked again
+static void readFence(void) {
+#if defined(_WIN32)
+    MemoryBarrier();
+#else
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+}
+
+static size_t alignUp(size_t value) {
+    return (value + SEGMENT_ALIGN - 1) & ~(size_t)(SEGMENT_ALIGN - 1);
+}
+
+static SharedStateFrame *frameAt(const SharedStateHeader *header, uint32_t index) {
+    return (SharedStateFrame *)((char *)header + header->frameOffset + (size_t)header->frameStride * index);
+}
+
+static BodyState *bodiesOf(const SharedStateFrame *frame) {
+    return (BodyState *)(frame + 1);
+}
+
+// Magic, version and a layout that fits the mapping
+static bool isValidSegment(const SharedStateHeader *header, size_t size) {
+    if (size < sizeof(SharedStateHeader)) return false;
+    if (loadAcquire(&header->magic) != SHARED_STATE_MAGIC || header->version != SHARED_STATE_VERSION) return false;
+    if (header->frameStride < sizeof(SharedStateFrame) + sizeof(BodyState) * (size_t)header->capacity) return false;
+    return header->frameOffset >= sizeof(SharedStateHeader) &&
+           (size_t)header->frameOffset + (size_t)header->frameStride * SHARED_STATE_FRAMES <= size;
+}
+
+static uint32_t currentPid(void) {
+#if defined(_WIN32)
+    return (uint32_t)GetCurrentProcessId();
+#else
+    return (uint32_t)getpid();
+#endif
+}
+
+// Not the publish time: a demo loading its window or paused in a debugger
+// publishes nothing for a while and still owns the segment
+static bool processExists(uint32_t pid) {
+    if (pid == 0) return false;
+#if defined(_WIN32)
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)pid);
+    if (!process) return GetLastError() == ERROR_ACCESS_DENIED;
+    bool running = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return running;
+#else
+    return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+#endif
+}
+
+// A demo owns the segment: it has not closed it and has not crashed
+static bool isLiveSegment(const SharedStateHeader *header, size_t size) {
+    return isValidSegment(header, size) && loadAcquire(&header->writerActive) && processExists(header->writerPid);
+}
+
+static void initSegment(SharedStateHeader *header, size_t size, const char *engine, int capacity) {
+    // Readers still mapped to a reused segment drop it until the magic is back
+    storeRelease(&header->magic, 0);
+    memset((char *)header + sizeof(header->magic), 0, size - sizeof(header->magic));
+    header->version = SHARED_STATE_VERSION;
+    header->capacity = (uint32_t)capacity;
+    header->frameOffset = (uint32_t)alignUp(sizeof(SharedStateHeader));
+    header->frameStride = (uint32_t)alignUp(sizeof(SharedStateFrame) + sizeof(BodyState) * (size_t)capacity);
+    header->writerActive = 1;
+    header->writerPid = currentPid();
+    header->segmentId = ((uint64_t)header->writerPid << 32) ^ (uint64_t)(PerfNowSeconds() * 1e6);
+    snprintf(header->engine, sizeof(header->engine), "%s", engine);
+    storeRelease(&header->magic, SHARED_STATE_MAGIC);
+}
+
+bool OpenSharedStateWriter(SharedStateWriter *writer, const char *name, const char *engine, int capacity) {
+    memset(writer, 0, sizeof(*writer));
+    writer->handle = -1;
+    if (capacity < 1) capacity = 1;
+    snprintf(writer->name, sizeof(writer->name), "%s", name);
+
+    size_t size = alignUp(sizeof(SharedStateHeader)) +
+                  alignUp(sizeof(SharedStateFrame) + sizeof(BodyState) * (size_t)capacity) * SHARED_STATE_FRAMES;
+    void *memory = NULL;
+
+#if defined(_WIN32)
+    char path[80];
+    snprintf(path, sizeof(path), "Local\\%s", name);
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                        (DWORD)((uint64_t)size >> 32), (DWORD)size, path);
+    if (!mapping) {
+        printf("Shared state: cannot create %s (error %lu)\n", path, GetLastError());
+        return false;
+    }
+    // A mapping left open by readers of a previous run keeps its size, reuse it when it fits
+    bool existed = GetLastError() == ERROR_ALREADY_EXISTS;
+    memory = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!memory || (existed && isLiveSegment((const SharedStateHeader *)memory, size))) {
+        printf("Shared state: %s is %s, use another --shm name\n", path, memory ? "in use by another demo" : "too small");
+        if (memory) UnmapViewOfFile(memory);
+        CloseHandle(mapping);
+        return false;
+    }
+    writer->handle = (intptr_t)mapping;
+#else
+    char path[80];
+    snprintf(path, sizeof(path), "/%s", name);
+
+    // A stale segment of a crashed run is replaced, its readers keep their mapping until they reattach
+    int existing = shm_open(path, O_RDONLY, 0);
+    if (existing >= 0) {
+        struct stat info;
+        bool live = false;
+        if (fstat(existing, &info) == 0 && (size_t)info.st_size >= sizeof(SharedStateHeader)) {
+            void *old = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, existing, 0);
+            if (old != MAP_FAILED) {
+                live = isLiveSegment((const SharedStateHeader *)old, (size_t)info.st_size);
+                munmap(old, (size_t)info.st_size);
+            }
+        }
+        close(existing);
+        if (live) {
+            printf("Shared state: %s is in use by another demo, use another --shm name\n", path);
+            return false;
+        }
+        shm_unlink(path);
+    }
+
+    int fd = shm_open(path, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        printf("Shared state: cannot create %s\n", path);
+        return false;
+    }
+    if (ftruncate(fd, (off_t)size) == 0) {
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (memory == MAP_FAILED) memory = NULL;
+    }
+    close(fd);  // The mapping keeps the segment
+    if (!memory) {
+        printf("Shared state: cannot map %zu bytes for %s\n", size, path);
+        shm_unlink(path);
+        return false;
+    }
+#endif
+
+    writer->header = (SharedStateHeader *)memory;
+    writer->size = size;
+    initSegment(writer->header, size, engine, capacity);
+    printf("Shared state: publishing %d bodies to %s (%zu bytes)\n", capacity, path, size);
+    return true;
+}
+
+void CloseSharedStateWriter(SharedStateWriter *writer) {
+    if (!writer->header) return;
+    storeRelease(&writer->header->writerActive, 0);
+
+#if defined(_WIN32)
+    UnmapViewOfFile(writer->header);
+    CloseHandle((HANDLE)writer->handle);
+#else
+    munmap(writer->header, writer->size);
+    char path[80];
+    snprintf(path, sizeof(path), "/%s", writer->name);
+    shm_unlink(path);
+#endif
+    memset(writer, 0, sizeof(*writer));
+    writer->handle = -1;
+}
+
+BodyState *BeginSharedStatePublish(SharedStateWriter *writer) {
+    if (!writer->header) return NULL;
+
+    // Readers are pointed at latest, the other frame is free until latest flips
+    SharedStateFrame *frame = frameAt(writer->header, (writer->header->latest + 1) % SHARED_STATE_FRAMES);
+    frame->sequence = frame->sequence + 1;
+    writeFence();
+    writer->frame = frame;
+    return bodiesOf(frame);
+}
+
+void EndSharedStatePublish(SharedStateWriter *writer, int bodyCount) {
+    SharedStateFrame *frame = writer->frame;
+    if (!frame) return;
+
+    if (bodyCount < 0) bodyCount = 0;
+    if ((uint32_t)bodyCount > writer->header->capacity) bodyCount = (int)writer->header->capacity;
+    frame->bodyCount = (uint32_t)bodyCount;
+    frame->publishIndex = ++writer->published;
+    frame->publishSeconds = PerfNowSeconds();
+
+    storeRelease(&frame->sequence, frame->sequence + 1);
+    uint32_t index = (uint32_t)(((char *)frame - (char *)writer->header - writer->header->frameOffset) / writer->header->frameStride);
+    storeRelease(&writer->header->latest, index);
+    writer->frame = NULL;
+}
+
+void PublishSharedState(SharedStateWriter *writer, void (*gather)(void *user, BodyState *states, int count),
+                        void *user, int bodyCount) {
+    BodyState *states = BeginSharedStatePublish(writer);
+    if (!states) return;
+    if (bodyCount > (int)writer->header->capacity) bodyCount = (int)writer->header->capacity;
+    gather(user, states, bodyCount);
+    EndSharedStatePublish(writer, bodyCount);
+}
+
+bool OpenSharedStateReader(SharedStateReader *reader, const char *name) {
+    memset(reader, 0, sizeof(*reader));
+    reader->handle = -1;
+    const void *memory = NULL;
+    size_t size = 0;
+
+#if defined(_WIN32)
+    char path[80];
+    snprintf(path, sizeof(path), "Local\\%s", name);
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, path);
+    if (!mapping) return false;
+    memory = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if (memory && VirtualQuery(memory, &info, sizeof(info))) size = info.RegionSize;
+    if (!memory || !isValidSegment((const SharedStateHeader *)memory, size)) {
+        if (memory) UnmapViewOfFile(memory);
+        CloseHandle(mapping);
+        return false;
+    }
+    reader->handle = (intptr_t)mapping;
+#else
+    char path[80];
+    snprintf(path, sizeof(path), "/%s", name);
+    int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(SharedStateHeader)) {
+        size = (size_t)info.st_size;
+        memory = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (memory == MAP_FAILED) memory = NULL;
+    }
+    close(fd);
+    if (!memory) return false;
+    if (!isValidSegment((const SharedStateHeader *)memory, size)) {
+        munmap((void *)memory, size);
+        return false;
+    }
+#endif
+
+    reader->header = (const SharedStateHeader *)memory;
+    reader->size = size;
+    return true;
+}
+
+void CloseSharedStateReader(SharedStateReader *reader) {
+    if (!reader->header) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(reader->header);
+    CloseHandle((HANDLE)reader->handle);
+#else
+    munmap((void *)reader->header, reader->size);
+#endif
+    memset(reader, 0, sizeof(*reader));
+    reader->handle = -1;
+}
+
+bool IsSharedStateWriterActive(const SharedStateReader *reader) {
+    return reader->header && loadAcquire(&reader->header->magic) == SHARED_STATE_MAGIC &&
+           loadAcquire(&reader->header->writerActive) != 0 && processExists(reader->header->writerPid);
+}
+
+bool BeginSharedStateRead(const SharedStateReader *reader, SharedStateView *view) {
+    if (!reader->header) return false;
+
+    for (int attempt = 0; attempt < READ_RETRIES; attempt++) {
+        const SharedStateFrame *frame = frameAt(reader->header, loadAcquire(&reader->header->latest) % SHARED_STATE_FRAMES);
+        uint32_t sequence = loadAcquire(&frame->sequence);
+        if (sequence == 0) return false;    // Nothing published yet
+        if (sequence & 1) continue;         // Lapped, the writer is refilling it already
+
+        view->frame = frame;
+        view->bodies = bodiesOf(frame);
+        view->bodyCount = frame->bodyCount < reader->header->capacity ? (int)frame->bodyCount : (int)reader->header->capacity;
+        view->sequence = sequence;
+        return true;
+    }
+    return false;
+}
+
+bool EndSharedStateRead(const SharedStateReader *reader, const SharedStateView *view) {
+    (void)reader;
+    readFence();
+    return view->frame->sequence == view->sequence;
+}
+
+int ReadSharedState(const SharedStateReader *reader, BodyState *states, int capacity,
+                    uint64_t *publishIndex, double *publishSeconds) {
+    for (int attempt = 0; attempt < READ_RETRIES; attempt++) {
+        SharedStateView view;
+        if (!BeginSharedStateRead(reader, &view)) return -1;
+
+        int count = view.bodyCount < capacity ? view.bodyCount : capacity;
+        memcpy(states, view.bodies, sizeof(BodyState) * (size_t)count);
+        uint64_t index = view.frame->publishIndex;
+        double seconds = view.frame->publishSeconds;
+        if (!EndSharedStateRead(reader, &view)) continue;
+
+        if (publishIndex) *publishIndex = index;
+        if (publishSeconds) *publishSeconds = seconds;
+        return count;
+    }
+    return -1;
+}
@@ -0,0 +1,107 @@
+// Body transforms published into shared memory for out-of-process readers.
+//
+// The demo (--shm) is the only writer. The segment holds a header and two
+// frames; each publish fills the frame readers are not pointed at, bracketed
+// by its sequence counter (odd while writing), then flips `latest`. The
+// writer never waits: a reader that is still on a frame when it gets reused
+// two publishes later sees the sequence change and drops or retries its read.
+// Readers map the segment read-only and use the bodies in place, so any
+// number of viewers, recorders or scrapers can attach, stall, crash or detach
+// without the simulation noticing.
+//
+// POSIX shm_open("/NAME") or a Windows file mapping named "Local\NAME".
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "body_state.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define SHARED_STATE_DEFAULT_NAME "physics_demo_state"
+#define SHARED_STATE_MAGIC 0x31534850u     // "PHS1"
+#define SHARED_STATE_VERSION 2
+#define SHARED_STATE_FRAMES 2
+
+typedef struct SharedStateHeader {
+    uint32_t magic;             // Written last, readers ignore the segment until it matches
+    uint32_t version;
+    uint32_t capacity;          // Bodies per frame
+    uint32_t frameOffset;       // First frame, from the start of the segment
+    uint32_t frameStride;       // Bytes between frames
+    volatile uint32_t latest;   // Frame last completed by the writer
+    volatile uint32_t writerActive;     // Cleared when the demo closes the segment
+    uint32_t writerPid;         // Owning demo, a set writerActive with a dead process is a crashed run
+    uint64_t segmentId;         // New per OpenSharedStateWriter, tells a replaced segment from the old one
+    char engine[32];            // Publishing demo, e.g. "Jolt"
+} SharedStateHeader;
+
+typedef struct SharedStateFrame {
+    volatile uint32_t sequence; // Odd while the writer fills this frame, 0 before the first publish
+    uint32_t bodyCount;
+    uint64_t publishIndex;      // Publishes since the segment was opened, readers spot missed frames
+    double publishSeconds;      // PerfNowSeconds() at publish, the clock is system wide
+} SharedStateFrame;             // Followed by capacity BodyStates
+
+typedef struct SharedStateWriter {
+    SharedStateHeader *header;  // NULL when not publishing
+    SharedStateFrame *frame;    // Being filled between Begin and End
+    size_t size;
+    intptr_t handle;
+    uint64_t published;
+    char name[64];
+} SharedStateWriter;
+
+typedef struct SharedStateReader {
+    const SharedStateHeader *header;    // NULL when detached
+    size_t size;
+    intptr_t handle;
+} SharedStateReader;
+
+// Zero-copy read of one frame, valid until EndSharedStateRead
+typedef struct SharedStateView {
+    const SharedStateFrame *frame;
+    const BodyState *bodies;    // Inside the mapping
+    int bodyCount;              // Clamped to the capacity
+    uint32_t sequence;
+} SharedStateView;
+
+// Creates the segment for capacity bodies, or replaces one whose demo exited or crashed
+bool OpenSharedStateWriter(SharedStateWriter *writer, const char *name, const char *engine, int capacity);
+// Marks the writer gone and removes the name, mapped readers keep their view
+void CloseSharedStateWriter(SharedStateWriter *writer);
+
+// Bodies of the back frame to fill, NULL when the writer is not open
+BodyState *BeginSharedStatePublish(SharedStateWriter *writer);
+void EndSharedStatePublish(SharedStateWriter *writer, int bodyCount);
+
+// Begin, gather (same signature as NetServerCallbacks.gather), End; no-op when not open
+void PublishSharedState(SharedStateWriter *writer, void (*gather)(void *user, BodyState *states, int count),
+                        void *user, int bodyCount);
+
+// Maps an existing segment read-only, false when no demo publishes under name
+bool OpenSharedStateReader(SharedStateReader *reader, const char *name);
+void CloseSharedStateReader(SharedStateReader *reader);
+// The demo has not closed the segment and its process is still running
+bool IsSharedStateWriterActive(const SharedStateReader *reader);
+
+// Points view at the latest complete frame, false when nothing is published yet
+bool BeginSharedStateRead(const SharedStateReader *reader, SharedStateView *view);
+// True when the writer did not reuse the frame while it was read
+bool EndSharedStateRead(const SharedStateReader *reader, const SharedStateView *view);
+
+// Copies the latest frame into states, retrying torn reads.
+// Returns the body count, -1 when nothing is published or every retry was torn.
+int ReadSharedState(const SharedStateReader *reader, BodyState *states, int capacity,
+                    uint64_t *publishIndex, double *publishSeconds);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SHARED_STATE_H
@@ -0,0 +1,130 @@
+#include "step_profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLE_STRIDE (1 + STEP_PHASE_COUNT)
+
+static const char *phaseNames[STEP_PHASE_COUNT] = {
+    "broadphase",
+    "narrowphase",
+    "constraint_setup",
+    "solve",
+    "integrate",
+};
+
+StepPhase ClassifyStepScope(const StepPhaseRule *rules, int ruleCount, const char *name) {
+    if (!name) return STEP_PHASE_NONE;
+    for (int i = 0; i < ruleCount; i++) {
+        if (strstr(name, rules[i].match)) return rules[i].phase;
+    }
+    return STEP_PHASE_NONE;
+}
+
+void InitStepProfile(StepProfile *profile, const char *engine, const char *source, int expectedSteps) {
+    memset(profile, 0, sizeof(*profile));
+    profile->engine = engine;
+    profile->source = source;
+    profile->stepCapacity = expectedSteps > 0 ? expectedSteps : 256;
+    profile->samples = (float *)malloc(sizeof(float) * SAMPLE_STRIDE * (size_t)profile->stepCapacity);
+    if (!profile->samples) {
+        printf("%s: out of memory for %d profiled steps\n", engine, profile->stepCapacity);
+        profile->stepCapacity = 0;
+        profile->outOfMemory = true;
+    }
+}
+
+void UnloadStepProfile(StepProfile *profile) {
+    free(profile->samples);
+    memset(profile, 0, sizeof(*profile));
+}
+
+void AddStepPhaseTime(StepProfile *profile, StepPhase phase, double seconds) {
+    if (phase >= 0 && phase < STEP_PHASE_COUNT) profile->phases[phase] += seconds;
+}
+
+void RecordProfiledStep(StepProfile *profile, double wallSeconds) {
+    if (!profile->outOfMemory && profile->stepCount == profile->stepCapacity) {
+        int capacity = profile->stepCapacity * 2;
+        float *samples = (float *)realloc(profile->samples, sizeof(float) * SAMPLE_STRIDE * (size_t)capacity);
+        if (samples) {
+            profile->samples = samples;
+            profile->stepCapacity = capacity;
+        } else {
+            printf("%s: out of memory, profile stops at %d steps\n", profile->engine, profile->stepCount);
+            profile->outOfMemory = true;
+        }
+    }
+    if (profile->outOfMemory) {
+        for (int i = 0; i < STEP_PHASE_COUNT; i++) profile->phases[i] = 0.0;
+        return;
+    }
+
+    float *row = profile->samples + SAMPLE_STRIDE * profile->stepCount++;
+    row[0] = (float)(wallSeconds * 1000.0);
+    for (int i = 0; i < STEP_PHASE_COUNT; i++) {
+        row[1 + i] = (float)(profile->phases[i] * 1000.0);
+        profile->phases[i] = 0.0;
+    }
+}
+
+// Wall minus the phases, never negative: multithreaded engines report CPU time summed over threads
+static float otherMs(const float *row) {
+    float other = row[0];
+    for (int i = 0; i < STEP_PHASE_COUNT; i++) other -= row[1 + i];
+    return other > 0.0f ? other : 0.0f;
+}
+
+void PrintStepProfile(const StepProfile *profile) {
+    int count = profile->stepCount;
+    if (count == 0) {
+        printf("%s: no steps profiled\n", profile->engine);
+        return;
+    }
+
+    // Column 0 wall, 1..COUNT phases, COUNT + 1 other
+    double sum[STEP_PHASE_COUNT + 2] = { 0 };
+    float max[STEP_PHASE_COUNT + 2] = { 0 };
+    for (int s = 0; s < count; s++) {
+        const float *row = profile->samples + SAMPLE_STRIDE * s;
+        for (int c = 0; c < STEP_PHASE_COUNT + 2; c++) {
+            float value = c <= STEP_PHASE_COUNT ? row[c] : otherMs(row);
+            sum[c] += value;
+            if (value > max[c]) max[c] = value;
+        }
+    }
+
+    double wall = sum[0] > 0.0 ? sum[0] : 1.0;
+    printf("\n%s step profile, %d steps\n", profile->engine, count);
+    printf("%-18s %10s %10s %8s\n", "phase", "avg ms", "max ms", "% wall");
+    for (int c = 1; c <= STEP_PHASE_COUNT + 1; c++) {
+        const char *name = c <= STEP_PHASE_COUNT ? phaseNames[c - 1] : "other";
+        printf("%-18s %10.3f %10.3f %7.1f%%\n", name, sum[c] / count, max[c], sum[c] / wall * 100.0);
+    }
+    printf("%-18s %10.3f %10.3f %7.1f%%\n", "wall", sum[0] / count, max[0], 100.0);
+    printf("Phases from %s\n", profile->source);
+}
+
+bool ExportStepProfile(const StepProfile *profile, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        printf("%s: cannot write %s\n", profile->engine, path);
+        return false;
+    }
+
+    fprintf(file, "step,wall_ms");
+    for (int i = 0; i < STEP_PHASE_COUNT; i++) fprintf(file, ",%s_ms", phaseNames[i]);
+    fprintf(file, ",other_ms\n");
+
+    for (int s = 0; s < profile->stepCount; s++) {
+        const float *row = profile->samples + SAMPLE_STRIDE * s;
+        fprintf(file, "%d,%.4f", s, row[0]);
+        for (int i = 0; i < STEP_PHASE_COUNT; i++) fprintf(file, ",%.4f", row[1 + i]);
+        fprintf(file, ",%.4f\n", otherMs(row));
+    }
+
+    fclose(file);
+    printf("Step profile written to %s\n", path);
+    return true;
+}
@@ -0,0 +1,61 @@
+// Engine independent per-step phase breakdown.
+//
+// Each engine's profiler names its scopes differently; the engine glue maps
+// them onto the common phases with a rule table, adds the times for every
+// step and records the step's wall-clock time. The collected steps are
+// printed as a table and exported as CSV.
+#ifndef STEP_PROFILE_H
+#define STEP_PROFILE_H
+
+#include <stdbool.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef enum StepPhase {
+    STEP_PHASE_NONE = -1,           // Scope does not map to a phase, its children are looked at instead
+    STEP_PHASE_BROADPHASE = 0,      // AABB updates and pair finding
+    STEP_PHASE_NARROWPHASE,         // Shape vs shape contact generation
+    STEP_PHASE_CONSTRAINT_SETUP,    // Islands, contact and joint constraint preparation
+    STEP_PHASE_SOLVE,               // Velocity / position iterations
+    STEP_PHASE_INTEGRATE,           // Gravity, velocity and position integration
+    STEP_PHASE_COUNT
+} StepPhase;
+
+// Scope names containing match (case sensitive) belong to phase, first rule wins.
+// A STEP_PHASE_NONE rule sends a scope that spans several phases to its children.
+typedef struct StepPhaseRule {
+    const char *match;
+    StepPhase phase;
+} StepPhaseRule;
+
+typedef struct StepProfile {
+    const char *engine;
+    const char *source;             // What the phase times come from, printed under the table
+    double phases[STEP_PHASE_COUNT];    // Current step, seconds
+    float *samples;                 // Per recorded step: wall, then each phase, in ms
+    int stepCount;
+    int stepCapacity;
+    bool outOfMemory;               // Recording stopped at stepCount, later steps are not kept
+} StepProfile;
+
+StepPhase ClassifyStepScope(const StepPhaseRule *rules, int ruleCount, const char *name);
+
+void InitStepProfile(StepProfile *profile, const char *engine, const char *source, int expectedSteps);
+void UnloadStepProfile(StepProfile *profile);
+
+void AddStepPhaseTime(StepProfile *profile, StepPhase phase, double seconds);
+// Stores the current phases with the step's wall time and clears them for the next step
+void RecordProfiledStep(StepProfile *profile, double wallSeconds);
+
+// Average, max and share of wall time per phase; "other" is wall minus the phases
+void PrintStepProfile(const StepProfile *profile);
+// One row per step: step, wall_ms, one column per phase, other_ms
+bool ExportStepProfile(const StepProfile *profile, const char *path);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // STEP_PROFILE_H
@@ -0,0 +1,319 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "terrain_mesh.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <direct.h>
+#else
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define COOKED_MESH_MAGIC "PHYSCOOK"
+#define COOKED_MESH_VERSION 1u
+#define COOKED_MESH_ALIGN 16u
+
+// On-disk header, every section starts on a COOKED_MESH_ALIGN boundary
+typedef struct CookedMeshHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t hash;
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t blobOffset;
+    uint64_t blobSize;
+} CookedMeshHeader;
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + COOKED_MESH_ALIGN - 1) & ~(uint64_t)(COOKED_MESH_ALIGN - 1);
+}
+
+bool GenTerrainMesh(TerrainMesh *mesh, int cells, float cellSize, float height) {
+    memset(mesh, 0, sizeof(*mesh));
+    if (cells < 1 || cells > TERRAIN_MAX_CELLS) {
+        printf("Terrain: %d cells out of range (1..%d)\n", cells, TERRAIN_MAX_CELLS);
+        return false;
+    }
+    const int side = cells + 1;
+    const float origin = -0.5f * (float)cells * cellSize;
+
+    mesh->vertexCount = side * side;
+    mesh->triangleCount = cells * cells * 2;
+    mesh->vertices = (float *)malloc(sizeof(float) * 3 * (size_t)mesh->vertexCount);
+    mesh->indices = (uint32_t *)malloc(sizeof(uint32_t) * 3 * (size_t)mesh->triangleCount);
+    if (!mesh->vertices || !mesh->indices) {
+        printf("Terrain: out of memory for %d x %d cells\n", cells, cells);
+        FreeTerrainMesh(mesh);
+        return false;
+    }
+
+    for (int j = 0; j < side; j++) {
+        for (int i = 0; i < side; i++) {
+            float x = origin + (float)i * cellSize;
+            float z = origin + (float)j * cellSize;
+            float *v = &mesh->vertices[3 * (j * side + i)];
+            v[0] = x;
+            v[1] = 0.25f * height * (2.0f + sinf(x * 0.21f) + cosf(z * 0.17f));
+            v[2] = z;
+        }
+    }
+
+    uint32_t *t = mesh->indices;
+    for (int j = 0; j < cells; j++) {
+        for (int i = 0; i < cells; i++) {
+            uint32_t a = (uint32_t)(j * side + i);
+            uint32_t b = a + (uint32_t)side;
+            uint32_t c = a + 1;
+            uint32_t d = b + 1;
+            *t++ = a; *t++ = b; *t++ = c;
+            *t++ = c; *t++ = b; *t++ = d;
+        }
+    }
+    return true;
+}
+
+void FreeTerrainMesh(TerrainMesh *mesh) {
+    free(mesh->vertices);
+    free(mesh->indices);
+    memset(mesh, 0, sizeof(*mesh));
+}
+
+uint64_t HashBytes(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    if (hash == 0) hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t HashTerrainMesh(const TerrainMesh *mesh, const char *engineTag, uint32_t engineVersion) {
+    uint32_t formatVersion = COOKED_MESH_VERSION;
+    uint64_t hash = HashBytes(0, engineTag, strlen(engineTag));
+    hash = HashBytes(hash, &engineVersion, sizeof(engineVersion));
+    hash = HashBytes(hash, &formatVersion, sizeof(formatVersion));
+    hash = HashBytes(hash, mesh->vertices, sizeof(float) * 3 * (size_t)mesh->vertexCount);
+    hash = HashBytes(hash, mesh->indices, sizeof(uint32_t) * 3 * (size_t)mesh->triangleCount);
+    return hash;
+}
+
+// COOKED_MESH_DIR next to the executable, whatever the working directory
+static const char *cacheDirectory(void) {
+    static char directory[1024 + sizeof(COOKED_MESH_DIR)];
+    if (directory[0]) return directory;
+
+    char exe[1024] = { 0 };
+#if defined(_WIN32)
+    DWORD length = GetModuleFileNameA(NULL, exe, sizeof(exe));
+    if (length == 0 || length >= sizeof(exe)) exe[0] = 0;
+#elif defined(__APPLE__)
+    uint32_t length = sizeof(exe);
+    if (_NSGetExecutablePath(exe, &length) != 0) exe[0] = 0;
+#else
+    ssize_t length = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    exe[length > 0 ? length : 0] = 0;
+#endif
+
+    // Keep the trailing separator, no executable path falls back to the working directory
+    char *separator = strrchr(exe, '/');
+#if defined(_WIN32)
+    char *backslash = strrchr(exe, '\\');
+    if (backslash > separator) separator = backslash;
+#endif
+    if (separator) separator[1] = 0;
+    else exe[0] = 0;
+    snprintf(directory, sizeof(directory), "%s%s", exe, COOKED_MESH_DIR);
+    return directory;
+}
+
+void GetCookedMeshPath(char *path, size_t size, const char *engineTag, uint64_t hash) {
+    snprintf(path, size, "%s/%s_%016llx.bin", cacheDirectory(), engineTag, (unsigned long long)hash);
+}
+
+static bool writePadded(FILE *file, const void *data, size_t size, uint64_t *offset) {
+    static const unsigned char zeros[COOKED_MESH_ALIGN] = { 0 };
+    if (size > 0 && fwrite(data, 1, size, file) != size) return false;
+    *offset += size;
+    size_t padding = (size_t)(alignUp(*offset) - *offset);
+    if (padding > 0 && fwrite(zeros, 1, padding, file) != padding) return false;
+    *offset += padding;
+    return true;
+}
+
+bool SaveCookedMesh(const char *path, uint64_t hash, const TerrainMesh *mesh, const void *blob, size_t blobSize) {
+#if defined(_WIN32)
+    _mkdir(cacheDirectory());
+#else
+    mkdir(cacheDirectory(), 0755);
+#endif
+
+    size_t vertexBytes = sizeof(float) * 3 * (size_t)mesh->vertexCount;
+    size_t indexBytes = sizeof(uint32_t) * 3 * (size_t)mesh->triangleCount;
+
+    CookedMeshHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COOKED_MESH_MAGIC, sizeof(header.magic));
+    header.version = COOKED_MESH_VERSION;
+    header.headerSize = sizeof(CookedMeshHeader);
+    header.hash = hash;
+    header.vertexCount = (uint32_t)mesh->vertexCount;
+    header.triangleCount = (uint32_t)mesh->triangleCount;
+    header.vertexOffset = alignUp(sizeof(CookedMeshHeader));
+    header.indexOffset = alignUp(header.vertexOffset + vertexBytes);
+    header.blobOffset = alignUp(header.indexOffset + indexBytes);
+    header.blobSize = blobSize;
+
+    char tempPath[COOKED_MESH_PATH_MAX + 8];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = fopen(tempPath, "wb");
+    if (!file) {
+        printf("Cooked mesh: cannot write %s\n", tempPath);
+        return false;
+    }
+
+    uint64_t offset = 0;
+    bool ok = writePadded(file, &header, sizeof(header), &offset)
+           && writePadded(file, mesh->vertices, vertexBytes, &offset)
+           && writePadded(file, mesh->indices, indexBytes, &offset)
+           && writePadded(file, blob, blobSize, &offset);
+    ok = (fclose(file) == 0) && ok;
+
+    if (ok) {
+#if defined(_WIN32)
+        ok = MoveFileExA(tempPath, path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        ok = rename(tempPath, path) == 0;
+#endif
+    }
+    if (!ok) {
+        remove(tempPath);
+        printf("Cooked mesh: failed to save %s\n", path);
+    }
+    return ok;
+}
+
+// Aligned and inside the file, written so a corrupt offset cannot wrap around
+static bool sectionFits(uint64_t offset, uint64_t bytes, size_t fileSize) {
+    return offset % COOKED_MESH_ALIGN == 0 && offset <= fileSize && bytes <= fileSize - offset;
+}
+
+bool LoadCookedMesh(CookedMesh *cooked, const char *path, uint64_t hash) {
+    memset(cooked, 0, sizeof(*cooked));
+
+    // Private (copy-on-write) mapping: engines that patch pointers in place (Bullet's BVH)
+    // only dirty the pages they touch, everything else stays shared with the page cache.
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(CookedMeshHeader)) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    void *base = mapping ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) : NULL;
+    if (!base) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    cooked->fileHandle = file;
+    cooked->mappingHandle = mapping;
+    cooked->mapping = base;
+    cooked->mappingSize = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CookedMeshHeader)) {
+        close(fd);
+        return false;
+    }
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+    cooked->mapping = base;
+    cooked->mappingSize = (size_t)st.st_size;
+#endif
+
+    const CookedMeshHeader *header = (const CookedMeshHeader *)cooked->mapping;
+    uint64_t vertexBytes = sizeof(float) * 3 * (uint64_t)header->vertexCount;
+    uint64_t indexBytes = sizeof(uint32_t) * 3 * (uint64_t)header->triangleCount;
+    bool valid = memcmp(header->magic, COOKED_MESH_MAGIC, sizeof(header->magic)) == 0
+              && header->version == COOKED_MESH_VERSION
+              && header->headerSize == sizeof(CookedMeshHeader)
+              && header->hash == hash
+              && header->vertexCount <= INT_MAX && header->triangleCount <= INT_MAX
+              && sectionFits(header->vertexOffset, vertexBytes, cooked->mappingSize)
+              && sectionFits(header->indexOffset, indexBytes, cooked->mappingSize)
+              && sectionFits(header->blobOffset, header->blobSize, cooked->mappingSize);
+    if (!valid) {
+        printf("Cooked mesh: ignoring stale or corrupt %s\n", path);
+        UnloadCookedMesh(cooked);
+        return false;
+    }
+
+    unsigned char *bytes = (unsigned char *)cooked->mapping;
+    cooked->vertices = (const float *)(bytes + header->vertexOffset);
+    cooked->indices = (const uint32_t *)(bytes + header->indexOffset);
+    cooked->vertexCount = (int)header->vertexCount;
+    cooked->triangleCount = (int)header->triangleCount;
+    cooked->blob = bytes + header->blobOffset;
+    cooked->blobSize = (size_t)header->blobSize;
+    return true;
+}
+
+void UnloadCookedMesh(CookedMesh *cooked) {
+    if (cooked->mapping) {
+#if defined(_WIN32)
+        UnmapViewOfFile(cooked->mapping);
+        CloseHandle((HANDLE)cooked->mappingHandle);
+        CloseHandle((HANDLE)cooked->fileHandle);
+#else
+        munmap(cooked->mapping, cooked->mappingSize);
+#endif
+    }
+    memset(cooked, 0, sizeof(*cooked));
+}
+
+static void minAvg(const double *samples, int count, double *outMin, double *outAvg) {
+    double sum = 0.0;
+    *outMin = samples[0];
+    for (int i = 0; i < count; i++) {
+        sum += samples[i];
+        if (samples[i] < *outMin) *outMin = samples[i];
+    }
+    *outAvg = sum / (double)count;
+}
+
+void ReportCookBenchmark(const char *engineName, const TerrainMesh *mesh, const double *buildSeconds,
+                         const double *cookedSeconds, int iterations) {
+    double buildMin, buildAvg, cookedMin, cookedAvg;
+    minAvg(buildSeconds, iterations, &buildMin, &buildAvg);
+    minAvg(cookedSeconds, iterations, &cookedMin, &cookedAvg);
+
+    printf("Terrain startup benchmark (%s): %d vertices, %d triangles, %d iterations\n",
+           engineName, mesh->vertexCount, mesh->triangleCount, iterations);
+    printf("  %-20s min %9.3f ms  avg %9.3f ms\n", "build from scratch", buildMin * 1000.0, buildAvg * 1000.0);
+    printf("  %-20s min %9.3f ms  avg %9.3f ms\n", "cooked (mmap)", cookedMin * 1000.0, cookedAvg * 1000.0);
+    if (cookedAvg > 0.0) printf("  speedup: %.1fx\n", buildAvg / cookedAvg);
+}
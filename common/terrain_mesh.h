@@ -0,0 +1,71 @@
+// Procedural triangle-mesh terrain and the cooked collision-mesh cache.
+//
+// A cooked file holds the source vertices/indices plus an engine specific blob
+// (serialized BVH, preprocessed data, ...). It is keyed by a content hash of the
+// source mesh and the engine version, and is memory-mapped on load so the
+// engines can point straight into it instead of rebuilding their trees.
+#ifndef TERRAIN_MESH_H
+#define TERRAIN_MESH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define TERRAIN_MAX_CELLS 2048      // 8M triangles, keeps every count and index in range
+#define COOKED_MESH_DIR "cache"     // In the executable's directory
+#define COOKED_MESH_PATH_MAX 1100   // Buffer size for GetCookedMeshPath, the directory is absolute
+
+typedef struct TerrainMesh {
+    float *vertices;        // x, y, z per vertex
+    uint32_t *indices;      // 3 per triangle, counter clockwise seen from above
+    int vertexCount;
+    int triangleCount;
+} TerrainMesh;
+
+typedef struct CookedMesh {
+    const float *vertices;  // Points into the mapping
+    const uint32_t *indices;
+    int vertexCount;
+    int triangleCount;
+    void *blob;             // Engine data, 16 byte aligned, private copy-on-write pages
+    size_t blobSize;
+
+    void *mapping;
+    size_t mappingSize;
+#if defined(_WIN32)
+    void *fileHandle;
+    void *mappingHandle;
+#endif
+} CookedMesh;
+
+// Heightfield-like grid of cells x cells quads centered on the origin, heights in [0, height].
+// False (mesh left empty) when cells is out of [1, TERRAIN_MAX_CELLS] or allocation fails.
+bool GenTerrainMesh(TerrainMesh *mesh, int cells, float cellSize, float height);
+void FreeTerrainMesh(TerrainMesh *mesh);
+
+// 64-bit FNV-1a, chainable by passing the previous result as hash
+uint64_t HashBytes(uint64_t hash, const void *data, size_t size);
+// Cache key: mesh content + engine name/version, so an engine upgrade invalidates old files
+uint64_t HashTerrainMesh(const TerrainMesh *mesh, const char *engineTag, uint32_t engineVersion);
+
+// <executable dir>/COOKED_MESH_DIR/<engineTag>_<hash>.bin
+void GetCookedMeshPath(char *path, size_t size, const char *engineTag, uint64_t hash);
+// Writes to a temporary file and renames it into place
+bool SaveCookedMesh(const char *path, uint64_t hash, const TerrainMesh *mesh, const void *blob, size_t blobSize);
+// Maps the file and validates its header; false on miss, hash mismatch or corrupt file
+bool LoadCookedMesh(CookedMesh *cooked, const char *path, uint64_t hash);
+void UnloadCookedMesh(CookedMesh *cooked);
+
+// Prints min/avg for both startup paths
+void ReportCookBenchmark(const char *engineName, const TerrainMesh *mesh, const double *buildSeconds,
+                         const double *cookedSeconds, int iterations);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // TERRAIN_MESH_H
@@ -0,0 +1,46 @@
+#include "terrain_model.h"
+
+#include <math.h>
+#include <string.h>
+
+Model LoadTerrainModel(const float *vertices, const unsigned int *indices, int triangleCount) {
+    Mesh mesh = { 0 };
+    mesh.triangleCount = triangleCount;
+    mesh.vertexCount = triangleCount * 3;
+    mesh.vertices = (float *)MemAlloc(sizeof(float) * 3 * mesh.vertexCount);
+    mesh.normals = (float *)MemAlloc(sizeof(float) * 3 * mesh.vertexCount);
+    mesh.colors = (unsigned char *)MemAlloc(sizeof(unsigned char) * 4 * mesh.vertexCount);
+
+    // Baked directional shading, the default shader is unlit
+    const float light[3] = { 0.40f, 0.82f, 0.41f };
+
+    for (int t = 0; t < triangleCount; t++) {
+        const float *a = &vertices[3 * indices[3 * t + 0]];
+        const float *b = &vertices[3 * indices[3 * t + 1]];
+        const float *c = &vertices[3 * indices[3 * t + 2]];
+
+        float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length > 0.0f) {
+            n[0] /= length; n[1] /= length; n[2] /= length;
+        }
+
+        memcpy(&mesh.vertices[9 * t + 0], a, sizeof(float) * 3);
+        memcpy(&mesh.vertices[9 * t + 3], b, sizeof(float) * 3);
+        memcpy(&mesh.vertices[9 * t + 6], c, sizeof(float) * 3);
+        float shade = 0.45f + 0.55f * fmaxf(0.0f, n[0] * light[0] + n[1] * light[1] + n[2] * light[2]);
+        for (int k = 0; k < 3; k++) {
+            memcpy(&mesh.normals[9 * t + 3 * k], n, sizeof(n));
+            unsigned char *color = &mesh.colors[4 * (3 * t + k)];
+            color[0] = (unsigned char)(211 * shade);
+            color[1] = (unsigned char)(176 * shade);
+            color[2] = (unsigned char)(131 * shade);
+            color[3] = 255;
+        }
+    }
+
+    UploadMesh(&mesh, false);
+    return LoadModelFromMesh(mesh);
+}
@@ -0,0 +1,20 @@
+// raylib model for the static terrain triangles.
+// C++ demos include this inside their `namespace rl { }` block next to raylib.h.
+#ifndef TERRAIN_MODEL_H
+#define TERRAIN_MODEL_H
+
+#include "raylib.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Unindexed copy with flat normals and baked shading: raylib meshes only take
+// 16-bit indices, large terrains exceed that.
+Model LoadTerrainModel(const float *vertices, const unsigned int *indices, int triangleCount);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // TERRAIN_MODEL_H
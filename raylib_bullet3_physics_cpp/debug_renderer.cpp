@@ -0,0 +1,92 @@
+#include "debug_renderer.h"
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+uint32_t toColor(const btVector3& color) {
+    return DEBUG_DRAW_RGBA(color.x() * 255.0f, color.y() * 255.0f, color.z() * 255.0f, 255);
+}
+
+} // namespace
+
+void BulletDebugRenderer::DrawWorld(btDiscreteDynamicsWorld* world) {
+    // Bullet's own pass: shapes (wireframe), AABBs and contacts. Constraints are
+    // left out of the mode and drawn below so they get their own category.
+    int mode = DBG_NoDebug;
+    if (IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_SHAPES)) mode |= DBG_DrawWireframe;
+    if (IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_AABBS)) mode |= DBG_DrawAabb;
+    if (IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_CONTACTS)) mode |= DBG_DrawContactPoints;
+    setDebugMode(mode);
+    if (mode != DBG_NoDebug) {
+        mCategory = DEBUG_DRAW_SHAPES;
+        world->debugDrawWorld();
+    }
+
+    if (IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_CONSTRAINTS)) {
+        setDebugMode(DBG_DrawConstraints | DBG_DrawConstraintLimits);
+        mCategory = DEBUG_DRAW_CONSTRAINTS;
+        for (int i = world->getNumConstraints() - 1; i >= 0; i--) {
+            world->debugDrawConstraint(world->getConstraint(i));
+        }
+    }
+
+    if (IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_BROADPHASE)) {
+        drawBroadphase(world->getBroadphase());
+    }
+}
+
+void BulletDebugRenderer::drawBroadphase(btBroadphaseInterface* broadphase) {
+    btDbvtBroadphase* dbvt = dynamic_cast<btDbvtBroadphase*>(broadphase);
+    if (!dbvt) return;
+
+    // Internal nodes only, the leaves are the AABBs category. Deeper levels fade out.
+    struct Entry {
+        const btDbvtNode* node;
+        int depth;
+    };
+    std::vector<Entry> stack;
+    for (int set = 0; set < 2; set++) {
+        if (dbvt->m_sets[set].m_root) stack.push_back({ dbvt->m_sets[set].m_root, 0 });
+        const uint32_t base = set == 0 ? 0xffu : 0xffu << 8;    // dynamic set red, fixed set green
+        while (!stack.empty()) {
+            Entry entry = stack.back();
+            stack.pop_back();
+            if (!entry.node->isinternal()) continue;
+
+            float min[3] = { entry.node->volume.Mins().x(), entry.node->volume.Mins().y(), entry.node->volume.Mins().z() };
+            float max[3] = { entry.node->volume.Maxs().x(), entry.node->volume.Maxs().y(), entry.node->volume.Maxs().z() };
+            uint32_t alpha = (uint32_t)(entry.depth < 12 ? 255 - entry.depth * 16 : 63);
+            DebugDrawBox(&mDraw, DEBUG_DRAW_BROADPHASE, min, max, base | (alpha << 24));
+
+            stack.push_back({ entry.node->childs[0], entry.depth + 1 });
+            stack.push_back({ entry.node->childs[1], entry.depth + 1 });
+        }
+    }
+}
+
+void BulletDebugRenderer::drawLine(const btVector3& from, const btVector3& to, const btVector3& color) {
+    float a[3] = { from.x(), from.y(), from.z() };
+    float b[3] = { to.x(), to.y(), to.z() };
+    DebugDrawLine(&mDraw, mCategory, a, b, toColor(color));
+}
+
+void BulletDebugRenderer::drawAabb(const btVector3& from, const btVector3& to, const btVector3& color) {
+    float min[3] = { from.x(), from.y(), from.z() };
+    float max[3] = { to.x(), to.y(), to.z() };
+    DebugDrawBox(&mDraw, DEBUG_DRAW_AABBS, min, max, toColor(color));
+}
+
+void BulletDebugRenderer::drawContactPoint(const btVector3& PointOnB, const btVector3& normalOnB, btScalar,
+                                           int, const btVector3& color) {
+    float point[3] = { PointOnB.x(), PointOnB.y(), PointOnB.z() };
+    float normal[3] = { normalOnB.x(), normalOnB.y(), normalOnB.z() };
+    DebugDrawContact(&mDraw, point, normal, toColor(color));
+}
+
+void BulletDebugRenderer::reportErrorWarning(const char* warningString) {
+    printf("Bullet: %s\n", warningString);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// btIDebugDraw writing into the shared batched DebugDraw buffers. Bullet
+// reports everything through drawLine, the overrides below tag each line
+// with the category that produced it. Broadphase nodes are not drawn by
+// Bullet at all, they are walked from the btDbvtBroadphase trees here.
+
+#include <btBulletDynamicsCommon.h>
+
+#include "debug_draw.h"
+
+class BulletDebugRenderer final : public btIDebugDraw {
+public:
+    explicit BulletDebugRenderer(DebugDraw& draw) : mDraw(draw) {}
+
+    // Shapes, AABBs, contacts, constraints and broadphase nodes for the current state
+    void DrawWorld(btDiscreteDynamicsWorld* world);
+
+    virtual void drawLine(const btVector3& from, const btVector3& to, const btVector3& color) override;
+    virtual void drawAabb(const btVector3& from, const btVector3& to, const btVector3& color) override;
+    virtual void drawContactPoint(const btVector3& PointOnB, const btVector3& normalOnB, btScalar distance,
+                                  int lifeTime, const btVector3& color) override;
+    virtual void reportErrorWarning(const char* warningString) override;
+    virtual void draw3dText(const btVector3& location, const char* textString) override {}
+    virtual void setDebugMode(int debugMode) override { mDebugMode = debugMode; }
+    virtual int getDebugMode() const override { return mDebugMode; }
+
+private:
+    void drawBroadphase(btBroadphaseInterface* broadphase);
+
+    DebugDraw& mDraw;
+    unsigned int mCategory = DEBUG_DRAW_SHAPES;
+    int mDebugMode = DBG_NoDebug;
+};
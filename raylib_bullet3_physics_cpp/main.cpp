@@ -4,23 +4,89 @@
 #include <cstdlib>
 #include <ctime>
 #include <stdio.h>
+#include <vector>
+
+#include "body_state.h"
+#include "debug_draw.h"
+#include "debug_renderer.h"
+#include "demo_options.h"
+#include "net_server.h"
+#include "perf_timer.h"
+#include "shared_state.h"
+#include "step_profiler.h"
+#include "terrain_cache.h"
+#include "terrain_model.h"
 
 float randomFloat(float range) {
     return ((float)rand() / RAND_MAX) * 2 * range - range;
 }
 
-int main() {
+// Puts every cube back at its spawn point, with a random orientation when randomize is set
+void resetCubes(const std::vector<btRigidBody*>& cubes, bool randomize) {
+    for (size_t i = 0; i < cubes.size(); i++) {
+        float spawn[3];
+        GetSpawnPosition((int)i, 5.0f, spawn);
+        btTransform resetTransform;
+        resetTransform.setIdentity();
+        resetTransform.setOrigin(btVector3(spawn[0], spawn[1], spawn[2]));
+        if (randomize) {
+            float angleX = randomFloat(3.14159f);
+            float angleY = randomFloat(3.14159f);
+            float angleZ = randomFloat(3.14159f);
+            btQuaternion randomRotation;
+            randomRotation.setEulerZYX(angleZ, angleY, angleX);
+            resetTransform.setRotation(randomRotation);
+        }
+
+        btRigidBody* cube = cubes[i];
+        cube->setWorldTransform(resetTransform);
+        cube->getMotionState()->setWorldTransform(resetTransform);
+        cube->setLinearVelocity(btVector3(0, 0, 0));
+        cube->setAngularVelocity(btVector3(0, 0, 0));
+        cube->activate(true);
+    }
+}
+
+// State handed to the simulation server (--server) and shared state (--shm) callbacks
+struct ServerContext {
+    btDiscreteDynamicsWorld* world;
+    std::vector<btRigidBody*>* cubes;
+    SharedStateWriter* sharedState;
+};
+
+// Transforms of the first count cubes
+void gatherCubeStates(void* user, BodyState* states, int count) {
+    const std::vector<btRigidBody*>& cubes = *static_cast<ServerContext*>(user)->cubes;
+    for (int i = 0; i < count; i++) {
+        const btTransform& transform = cubes[i]->getCenterOfMassTransform();
+        btQuaternion rotation = transform.getRotation();
+        btVector3 halfExtents = static_cast<btBoxShape*>(cubes[i]->getCollisionShape())->getHalfExtentsWithMargin();
+        for (int k = 0; k < 3; k++) {
+            states[i].position[k] = (float)transform.getOrigin()[k];
+            states[i].rotation[k] = (float)rotation[k];
+            states[i].halfExtents[k] = (float)halfExtents[k];
+        }
+        states[i].rotation[3] = (float)rotation.w();
+    }
+}
+
+int main(int argc, char** argv) {
     srand((unsigned int)time(nullptr));
 
-    InitWindow(800, 600, "Drop Cube Test - Bullet3 & raylib");
-    SetTargetFPS(60);
+    DemoOptions options;
+    ParseDemoOptions(&options, argc, argv);
 
-    Camera3D camera = { 0 };
-    camera.position = { 0.0f, 10.0f, 10.0f }; // Initial position
-    camera.target = { 0.0f, 0.0f, 0.0f };     // Initial target
-    camera.up = { 0.0f, 1.0f, 0.0f };         // Initial up vector
-    camera.fovy = 45.0f;
-    camera.projection = CAMERA_PERSPECTIVE;
+    // Static terrain, generated here; in a real level this is the loaded asset
+    TerrainMesh terrainMesh = { 0 };
+    if (options.terrainCells > 0 && !GenTerrainMesh(&terrainMesh, options.terrainCells, 1.0f, 2.0f)) {
+        return 1;
+    }
+
+    if (options.benchCookIterations > 0) {
+        RunTerrainCookBenchmark(terrainMesh, options.benchCookIterations);
+        FreeTerrainMesh(&terrainMesh);
+        return 0;
+    }
 
     btBroadphaseInterface* broadphase = new btDbvtBroadphase();
     btDefaultCollisionConfiguration* collisionConfig = new btDefaultCollisionConfiguration();
@@ -35,6 +101,22 @@ int main() {
     btRigidBody* groundRb = new btRigidBody(groundRbInfo);
     dynamicsWorld->addRigidBody(groundRb);
 
+    // Terrain from the cooked cache (built and cooked on first run)
+    TerrainCollision terrain;
+    btDefaultMotionState* terrainMotionState = nullptr;
+    btRigidBody* terrainRb = nullptr;
+    Model terrainModel = { 0 };
+    if (terrainMesh.triangleCount > 0) {
+        double start = PerfNowSeconds();
+        LoadOrCookTerrain(terrainMesh, terrain);
+        terrainMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 0, 0)));
+        btRigidBody::btRigidBodyConstructionInfo terrainRbInfo(0, terrainMotionState, terrain.shape, btVector3(0, 0, 0));
+        terrainRb = new btRigidBody(terrainRbInfo);
+        dynamicsWorld->addRigidBody(terrainRb);
+        printf("Terrain created (%d triangles, %s) in %.2f ms\n", terrainMesh.triangleCount,
+               terrain.fromCache ? "cooked" : "built", (PerfNowSeconds() - start) * 1000.0);
+    }
+
     btCollisionShape* cubeShape = new btBoxShape(btVector3(0.5f, 0.5f, 0.5f));
     btDefaultMotionState* cubeMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 5, 0)));
     btScalar mass = 1.0f;
@@ -44,96 +126,178 @@ int main() {
     btRigidBody* cubeRb = new btRigidBody(cubeRbInfo);
     dynamicsWorld->addRigidBody(cubeRb);
 
-    Model cubeModel = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
-
-    char debugText[256];
-    bool mouseCaptured = false; // Track mouse capture state
+    // Extra cubes for --bodies, stacked above the demo cube and sharing its shape
+    std::vector<btRigidBody*> cubes = { cubeRb };
+    for (int i = 1; i < options.bodyCount; i++) {
+        float spawn[3];
+        GetSpawnPosition(i, 5.0f, spawn);
+        btDefaultMotionState* motionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(spawn[0], spawn[1], spawn[2])));
+        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState, cubeShape, cubeInertia);
+        cubes.push_back(new btRigidBody(rbInfo));
+        dynamicsWorld->addRigidBody(cubes.back());
+    }
 
-    // Initially capture the mouse
-    DisableCursor();
-    mouseCaptured = true;
+    // Out-of-process viewers (--shm), published after every step
+    SharedStateWriter sharedState = {};
+    if (options.sharedStateName && options.profileSteps == 0) {
+        OpenSharedStateWriter(&sharedState, options.sharedStateName, "Bullet", (int)cubes.size());
+    }
+    ServerContext context = { dynamicsWorld, &cubes, &sharedState };
 
-    while (!WindowShouldClose()) {
-        dynamicsWorld->stepSimulation(1.0f / 60.0f, 10);
+    // Headless: fixed number of steps with the per-phase breakdown
+    // or step at the server tick rate and stream state to viewers
+    int result = 0;
+    if (options.profileSteps > 0) {
+        RunStepProfile(dynamicsWorld, options.profileSteps);
+    } else if (options.serverPort > 0) {
+        NetServerConfig config = { (uint16_t)options.serverPort, options.tickRate,
+                                   (uint32_t)options.serverBudget, (int)cubes.size() };
+        NetServerCallbacks callbacks;
+        callbacks.user = &context;
+        callbacks.step = [](void* user, float dt) {
+            ServerContext* ctx = static_cast<ServerContext*>(user);
+            ctx->world->stepSimulation(dt, 1, dt);
+            PublishSharedState(ctx->sharedState, gatherCubeStates, ctx, (int)ctx->cubes->size());
+        };
+        callbacks.gather = gatherCubeStates;
+        callbacks.command = [](void* user, int command) {
+            resetCubes(*static_cast<ServerContext*>(user)->cubes, command == NET_COMMAND_RANDOMIZE);
+        };
+        result = RunNetServer(&config, &callbacks);
+    } else {
+        InitWindow(800, 600, "Drop Cube Test - Bullet3 & raylib");
+        SetTargetFPS(60);
 
-        // Reset cube with 'R'
-        if (IsKeyPressed(KEY_R)) {
-            btTransform resetTransform;
-            resetTransform.setIdentity();
-            resetTransform.setOrigin(btVector3(0, 5, 0));
-            float angleX = randomFloat(3.14159f);
-            float angleY = randomFloat(3.14159f);
-            float angleZ = randomFloat(3.14159f);
-            btQuaternion randomRotation;
-            randomRotation.setEulerZYX(angleZ, angleY, angleX);
-            resetTransform.setRotation(randomRotation);
+        Camera3D camera = { 0 };
+        camera.position = { 0.0f, 10.0f, 10.0f }; // Initial position
+        camera.target = { 0.0f, 0.0f, 0.0f };     // Initial target
+        camera.up = { 0.0f, 1.0f, 0.0f };         // Initial up vector
+        camera.fovy = 45.0f;
+        camera.projection = CAMERA_PERSPECTIVE;
 
-            cubeRb->setWorldTransform(resetTransform);
-            cubeRb->setLinearVelocity(btVector3(0, 0, 0));
-            cubeRb->setAngularVelocity(btVector3(0, 0, 0));
-            cubeRb->activate(true);
+        if (terrainRb) {
+            terrainModel = LoadTerrainModel(terrainMesh.vertices, terrainMesh.indices, terrainMesh.triangleCount);
         }
+        Model cubeModel = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
 
-        // Reset camera with '1'
-        if (IsKeyPressed(KEY_ONE)) {
-            camera.position = { 0.0f, 10.0f, 10.0f };
-            camera.target = { 0.0f, 0.0f, 0.0f };
-            camera.up = { 0.0f, 1.0f, 0.0f };
-        }
+        // Engine debug drawing, batched (F1..F5 toggle categories)
+        DebugDraw debugDraw;
+        InitDebugDraw(&debugDraw, options.debugDrawMax, (unsigned int)options.debugDrawCategories);
+        BulletDebugRenderer debugRenderer(debugDraw);
+        dynamicsWorld->setDebugDrawer(&debugRenderer);
+
+        char debugText[256];
+        bool mouseCaptured = false; // Track mouse capture state
+
+        // Initially capture the mouse
+        DisableCursor();
+        mouseCaptured = true;
+
+        while (!WindowShouldClose()) {
+            dynamicsWorld->stepSimulation(1.0f / 60.0f, 10);
+            PublishSharedState(&sharedState, gatherCubeStates, &context, (int)cubes.size());
+            UpdateDebugDrawToggles(&debugDraw);
+            BeginDebugDraw(&debugDraw);
+            debugRenderer.DrawWorld(dynamicsWorld);
+
+            // Reset cube with 'R'
+            if (IsKeyPressed(KEY_R)) {
+                resetCubes(cubes, true);
+            }
 
-        // Toggle mouse capture with Escape
-        if (IsKeyPressed(KEY_ESCAPE)) {
-            if (mouseCaptured) {
-                EnableCursor();
-                mouseCaptured = false;
-            } else {
-                DisableCursor();
-                mouseCaptured = true;
+            // Reset camera with '1'
+            if (IsKeyPressed(KEY_ONE)) {
+                camera.position = { 0.0f, 10.0f, 10.0f };
+                camera.target = { 0.0f, 0.0f, 0.0f };
+                camera.up = { 0.0f, 1.0f, 0.0f };
             }
+
+            // Toggle mouse capture with Escape
+            if (IsKeyPressed(KEY_ESCAPE)) {
+                if (mouseCaptured) {
+                    EnableCursor();
+                    mouseCaptured = false;
+                } else {
+                    DisableCursor();
+                    mouseCaptured = true;
+                }
+            }
+
+            btTransform cubeTransform;
+            cubeRb->getMotionState()->getWorldTransform(cubeTransform);
+            Vector3 cubePos = {
+                (float)cubeTransform.getOrigin().getX(),
+                (float)cubeTransform.getOrigin().getY(),
+                (float)cubeTransform.getOrigin().getZ()
+            };
+            btQuaternion cubeRot = cubeTransform.getRotation();
+            Quaternion raylibRot = { cubeRot.x(), cubeRot.y(), cubeRot.z(), cubeRot.w() };
+            Matrix rotMatrix = QuaternionToMatrix(raylibRot);
+            Matrix transMatrix = MatrixTranslate(cubePos.x, cubePos.y, cubePos.z);
+            cubeModel.transform = MatrixMultiply(rotMatrix, transMatrix);
+
+            // Update camera with free mode
+            UpdateCamera(&camera, CAMERA_FREE);
+
+            BeginDrawing();
+            ClearBackground(RAYWHITE);
+
+            BeginMode3D(camera);
+            DrawPlane({0, 0, 0}, {10, 10}, GRAY);
+            if (terrainRb) DrawModel(terrainModel, {0, 0, 0}, 1.0f, WHITE);
+            DrawModel(cubeModel, {0, 0, 0}, 1.0f, BLUE);
+            DrawModelWires(cubeModel, {0, 0, 0}, 1.0f, BLACK);
+            // With shapes on the batched debug wireframes replace the per-body draw calls
+            for (size_t i = 1; i < cubes.size() && !IsDebugDrawEnabled(&debugDraw, DEBUG_DRAW_SHAPES); i++) {
+                btTransform transform;
+                cubes[i]->getMotionState()->getWorldTransform(transform);
+                btQuaternion rotation = transform.getRotation();
+                const btVector3& origin = transform.getOrigin();
+                cubeModel.transform = MatrixMultiply(QuaternionToMatrix({ rotation.x(), rotation.y(), rotation.z(), rotation.w() }),
+                                                     MatrixTranslate(origin.x(), origin.y(), origin.z()));
+                DrawModel(cubeModel, {0, 0, 0}, 1.0f, SKYBLUE);
+                DrawModelWires(cubeModel, {0, 0, 0}, 1.0f, BLACK);
+            }
+            DrawGrid(10, 1.0f);
+            SubmitDebugDraw(&debugDraw);
+            EndMode3D();
+
+            // Draw debug info
+            sprintf(debugText, "Pos: (%.2f, %.2f, %.2f)", cubePos.x, cubePos.y, cubePos.z);
+            DrawText(debugText, 10, 30, 20, DARKGRAY);
+            sprintf(debugText, "Rot: (%.2f, %.2f, %.2f, %.2f)", cubeRot.x(), cubeRot.y(), cubeRot.z(), cubeRot.w());
+            DrawText(debugText, 10, 50, 20, DARKGRAY);
+
+            DrawFPS(10, 10);
+            DrawText("WASD: Move, Mouse: Look, Q/E: Up/Down", 10, 70, 10, DARKGRAY);
+            DrawText("R: Reset Cube, 1: Reset Camera, Esc: Toggle Mouse", 10, 90, 10, DARKGRAY);
+            DrawDebugDrawStats(&debugDraw, 10, 110);
+
+            EndDrawing();
         }
 
-        btTransform cubeTransform;
-        cubeRb->getMotionState()->getWorldTransform(cubeTransform);
-        Vector3 cubePos = {
-            (float)cubeTransform.getOrigin().getX(),
-            (float)cubeTransform.getOrigin().getY(),
-            (float)cubeTransform.getOrigin().getZ()
-        };
-        btQuaternion cubeRot = cubeTransform.getRotation();
-        Quaternion raylibRot = { cubeRot.x(), cubeRot.y(), cubeRot.z(), cubeRot.w() };
-        Matrix rotMatrix = QuaternionToMatrix(raylibRot);
-        Matrix transMatrix = MatrixTranslate(cubePos.x, cubePos.y, cubePos.z);
-        cubeModel.transform = MatrixMultiply(rotMatrix, transMatrix);
-
-        // Update camera with free mode
-        UpdateCamera(&camera, CAMERA_FREE);
-
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-
-        BeginMode3D(camera);
-        DrawPlane({0, 0, 0}, {10, 10}, GRAY);
-        DrawModel(cubeModel, {0, 0, 0}, 1.0f, BLUE);
-        DrawModelWires(cubeModel, {0, 0, 0}, 1.0f, BLACK);
-        DrawGrid(10, 1.0f);
-        EndMode3D();
-
-        // Draw debug info
-        sprintf(debugText, "Pos: (%.2f, %.2f, %.2f)", cubePos.x, cubePos.y, cubePos.z);
-        DrawText(debugText, 10, 30, 20, DARKGRAY);
-        sprintf(debugText, "Rot: (%.2f, %.2f, %.2f, %.2f)", cubeRot.x(), cubeRot.y(), cubeRot.z(), cubeRot.w());
-        DrawText(debugText, 10, 50, 20, DARKGRAY);
-
-        DrawFPS(10, 10);
-        DrawText("WASD: Move, Mouse: Look, Q/E: Up/Down", 10, 70, 10, DARKGRAY);
-        DrawText("R: Reset Cube, 1: Reset Camera, Esc: Toggle Mouse", 10, 90, 10, DARKGRAY);
-
-        EndDrawing();
+        dynamicsWorld->setDebugDrawer(nullptr);
+        UnloadDebugDraw(&debugDraw);
+        UnloadModel(cubeModel);
+        if (terrainRb) UnloadModel(terrainModel);
+        CloseWindow();
     }
 
-    UnloadModel(cubeModel);
+    CloseSharedStateWriter(&sharedState);
+    for (size_t i = 1; i < cubes.size(); i++) {
+        dynamicsWorld->removeRigidBody(cubes[i]);
+        delete cubes[i]->getMotionState();
+        delete cubes[i];
+    }
     dynamicsWorld->removeRigidBody(cubeRb);
     dynamicsWorld->removeRigidBody(groundRb);
+    if (terrainRb) {
+        dynamicsWorld->removeRigidBody(terrainRb);
+        delete terrainRb;
+        delete terrainMotionState;
+        DestroyTerrain(terrain);
+    }
+    FreeTerrainMesh(&terrainMesh);
     delete cubeRb;
     delete cubeShape;
     delete cubeMotionState;
@@ -146,6 +310,5 @@ int main() {
     delete collisionConfig;
     delete broadphase;
 
-    CloseWindow();
-    return 0;
+    return result;
 }
\ No newline at end of file
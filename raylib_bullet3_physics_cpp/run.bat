@@ -1,3 +1,3 @@
 @echo off
 cd build/Debug
-DropCubeTest.exe
\ No newline at end of file
+DropCubeTest.exe %*
\ No newline at end of file
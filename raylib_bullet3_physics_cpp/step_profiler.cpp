@@ -0,0 +1,82 @@
+#include "step_profiler.h"
+
+#include <LinearMath/btQuickprof.h>
+
+#include "perf_timer.h"
+#include "step_profile.h"
+
+#ifndef BT_NO_PROFILE
+
+namespace {
+
+// BT_PROFILE names in btDiscreteDynamicsWorld and btSequentialImpulseConstraintSolver.
+// performDiscreteCollisionDetection and solveConstraints span two phases, their children are used.
+const StepPhaseRule bulletRules[] = {
+    { "updateAabbs", STEP_PHASE_BROADPHASE },
+    { "calculateOverlappingPairs", STEP_PHASE_BROADPHASE },
+    { "dispatchAllCollisionPairs", STEP_PHASE_NARROWPHASE },
+    { "createPredictiveContacts", STEP_PHASE_NARROWPHASE },
+    { "calculateSimulationIslands", STEP_PHASE_CONSTRAINT_SETUP },
+    { "islandUnionFindAndQuickSort", STEP_PHASE_CONSTRAINT_SETUP },
+    { "CacheFriendlySetup", STEP_PHASE_CONSTRAINT_SETUP },
+    { "CacheFriendlyIterations", STEP_PHASE_SOLVE },
+    { "CacheFriendlyFinish", STEP_PHASE_SOLVE },
+    { "predictUnconstraintMotion", STEP_PHASE_INTEGRATE },
+    { "integrateTransforms", STEP_PHASE_INTEGRATE },
+};
+
+// Leaves the iterator on child index of the current parent, Enter_Parent rewinds it
+void seekChild(CProfileIterator* it, int index) {
+    it->First();
+    for (int i = 0; i < index && !it->Is_Done(); i++) it->Next();
+}
+
+void collectScopes(CProfileIterator* it, StepProfile& profile) {
+    for (int index = 0;; index++) {
+        seekChild(it, index);
+        if (it->Is_Done()) break;
+
+        StepPhase phase = ClassifyStepScope(bulletRules, (int)(sizeof(bulletRules) / sizeof(bulletRules[0])),
+                                            it->Get_Current_Name());
+        if (phase != STEP_PHASE_NONE) {
+            AddStepPhaseTime(&profile, phase, it->Get_Current_Total_Time() / 1000.0); // ms
+            continue;
+        }
+        it->Enter_Child(index);
+        collectScopes(it, profile);
+        it->Enter_Parent();
+    }
+}
+
+} // namespace
+
+#endif // BT_NO_PROFILE
+
+void RunStepProfile(btDiscreteDynamicsWorld* world, int steps) {
+    StepProfile profile;
+#ifndef BT_NO_PROFILE
+    InitStepProfile(&profile, "Bullet", "CProfileManager (BT_PROFILE) scopes", steps);
+    CProfileManager::Reset();
+#else
+    InitStepProfile(&profile, "Bullet", "nothing: configure with -DPHYSICS_PROFILE=ON for the phase times", steps);
+#endif
+
+    const btScalar dt = 1.0f / 60.0f;
+    for (int i = 0; i < steps; i++) {
+        double start = PerfNowSeconds();
+        world->stepSimulation(dt, 1, dt);
+        double wall = PerfNowSeconds() - start;
+#ifndef BT_NO_PROFILE
+        if (CProfileIterator* it = CProfileManager::Get_Iterator()) {
+            collectScopes(it, profile);
+            CProfileManager::Release_Iterator(it);
+        }
+        CProfileManager::Reset();
+#endif
+        RecordProfiledStep(&profile, wall);
+    }
+
+    PrintStepProfile(&profile);
+    ExportStepProfile(&profile, "step_profile_bullet.csv");
+    UnloadStepProfile(&profile);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// --profile for Bullet. With PHYSICS_PROFILE Bullet keeps its BT_PROFILE
+// scopes (otherwise the build defines BT_NO_PROFILE); after each step the
+// CProfileManager tree is walked, the outermost node matching a phase rule
+// takes its subtree's time, and the tree is reset for the next step.
+
+#include <btBulletDynamicsCommon.h>
+
+// Steps the scene, prints the phase table and writes step_profile_bullet.csv
+void RunStepProfile(btDiscreteDynamicsWorld* world, int steps);
@@ -0,0 +1,105 @@
+#include "terrain_cache.h"
+
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+
+#include <stdio.h>
+#include <vector>
+
+#include "perf_timer.h"
+
+// The serialized BVH embeds struct layouts, so pointer size and btScalar
+// (BT_USE_DOUBLE_PRECISION) are part of the key too
+static uint32_t bulletVersion() {
+    return (uint32_t)((btGetVersion() * 16 + sizeof(void*)) * 16 + sizeof(btScalar));
+}
+
+static void cookedPath(const TerrainMesh& mesh, char* path, size_t size, uint64_t* hash) {
+    *hash = HashTerrainMesh(&mesh, "bullet", bulletVersion());
+    GetCookedMeshPath(path, size, "bullet", *hash);
+}
+
+bool BuildTerrainShape(const TerrainMesh& mesh, TerrainCollision& terrain) {
+    terrain.meshInterface = new btTriangleIndexVertexArray(
+        mesh.triangleCount, (int*)mesh.indices, 3 * sizeof(uint32_t),
+        mesh.vertexCount, (btScalar*)mesh.vertices, 3 * sizeof(float));
+    terrain.shape = new btBvhTriangleMeshShape(terrain.meshInterface, true, true);
+    terrain.fromCache = false;
+    return true;
+}
+
+bool RestoreTerrainShape(TerrainCollision& terrain) {
+    CookedMesh& cooked = terrain.cooked;
+    btOptimizedBvh* bvh = btOptimizedBvh::deSerializeInPlace(cooked.blob, (unsigned int)cooked.blobSize, false);
+    if (!bvh) return false;
+
+    terrain.meshInterface = new btTriangleIndexVertexArray(
+        cooked.triangleCount, (int*)cooked.indices, 3 * sizeof(uint32_t),
+        cooked.vertexCount, (btScalar*)cooked.vertices, 3 * sizeof(float));
+    terrain.shape = new btBvhTriangleMeshShape(terrain.meshInterface, true, false);
+    terrain.shape->setOptimizedBvh(bvh);
+    terrain.fromCache = true;
+    return true;
+}
+
+bool LoadOrCookTerrain(const TerrainMesh& mesh, TerrainCollision& terrain) {
+    uint64_t hash;
+    char path[COOKED_MESH_PATH_MAX];
+    cookedPath(mesh, path, sizeof(path), &hash);
+
+    if (LoadCookedMesh(&terrain.cooked, path, hash)) {
+        if (RestoreTerrainShape(terrain)) return true;
+        UnloadCookedMesh(&terrain.cooked);
+    }
+
+    BuildTerrainShape(mesh, terrain);
+
+    btOptimizedBvh* bvh = terrain.shape->getOptimizedBvh();
+    unsigned int size = bvh->calculateSerializeBufferSize();
+    void* buffer = btAlignedAlloc(size, 16);
+    if (bvh->serializeInPlace(buffer, size, false) && SaveCookedMesh(path, hash, &mesh, buffer, size)) {
+        printf("Terrain cooked to %s (%u bytes)\n", path, size);
+    }
+    btAlignedFree(buffer);
+    return true;
+}
+
+void DestroyTerrain(TerrainCollision& terrain) {
+    // A deserialized BVH lives inside the mapping and is not owned by the shape
+    delete terrain.shape;
+    delete terrain.meshInterface;
+    UnloadCookedMesh(&terrain.cooked);
+    terrain.shape = nullptr;
+    terrain.meshInterface = nullptr;
+}
+
+void RunTerrainCookBenchmark(const TerrainMesh& mesh, int iterations) {
+    TerrainCollision warmup;
+    LoadOrCookTerrain(mesh, warmup);
+    DestroyTerrain(warmup);
+
+    uint64_t hash;
+    char path[COOKED_MESH_PATH_MAX];
+    cookedPath(mesh, path, sizeof(path), &hash);
+
+    std::vector<double> buildSeconds(iterations), cookedSeconds(iterations);
+    for (int i = 0; i < iterations; i++) {
+        TerrainCollision built;
+        double start = PerfNowSeconds();
+        BuildTerrainShape(mesh, built);
+        buildSeconds[i] = PerfNowSeconds() - start;
+        DestroyTerrain(built);
+
+        TerrainCollision restored;
+        start = PerfNowSeconds();
+        bool ok = LoadCookedMesh(&restored.cooked, path, hash) && RestoreTerrainShape(restored);
+        cookedSeconds[i] = PerfNowSeconds() - start;
+        DestroyTerrain(restored);
+
+        if (!ok) {
+            printf("Terrain benchmark aborted: cannot load %s\n", path);
+            return;
+        }
+    }
+
+    ReportCookBenchmark("Bullet btBvhTriangleMeshShape", &mesh, buildSeconds.data(), cookedSeconds.data(), iterations);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// Static terrain btBvhTriangleMeshShape: built from scratch, or attached to a
+// quantized BVH that was serialized in place into the cooked cache file.
+
+#include <btBulletDynamicsCommon.h>
+
+#include "terrain_mesh.h"
+
+struct TerrainCollision {
+    btTriangleIndexVertexArray* meshInterface = nullptr;
+    btBvhTriangleMeshShape* shape = nullptr;
+    CookedMesh cooked = {};   // Triangles and BVH nodes point into this mapping when fromCache
+    bool fromCache = false;
+};
+
+// Builds the quantized BVH over the source triangles (mesh must outlive the shape)
+bool BuildTerrainShape(const TerrainMesh& mesh, TerrainCollision& terrain);
+
+// Deserializes the BVH in place inside the mapping, no tree build
+bool RestoreTerrainShape(TerrainCollision& terrain);
+
+// Uses the cooked file for this mesh when present, otherwise builds and writes it
+bool LoadOrCookTerrain(const TerrainMesh& mesh, TerrainCollision& terrain);
+
+void DestroyTerrain(TerrainCollision& terrain);
+
+// Times both startup paths and prints the comparison
+void RunTerrainCookBenchmark(const TerrainMesh& mesh, int iterations);
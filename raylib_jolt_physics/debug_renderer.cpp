@@ -0,0 +1,80 @@
+#include "debug_renderer.h"
+
+#include <Jolt/Physics/Constraints/ContactConstraintManager.h>
+
+using namespace JPH;
+
+namespace {
+
+void toFloat3(RVec3Arg v, float out[3]) {
+    out[0] = (float)v.GetX();
+    out[1] = (float)v.GetY();
+    out[2] = (float)v.GetZ();
+}
+
+} // namespace
+
+void JoltDebugRenderer::BeginStep() {
+    mCategory = DEBUG_DRAW_CONTACTS;
+    mStepping = true;
+    ContactConstraintManager::sDrawContactPoint = IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_CONTACTS);
+}
+
+void JoltDebugRenderer::EndStep() {
+    ContactConstraintManager::sDrawContactPoint = false;
+    mStepping = false;
+}
+
+void JoltDebugRenderer::DrawWorld(PhysicsSystem& physics, RVec3Arg cameraPosition) {
+    SetCameraPos(cameraPosition);
+
+    if (IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_SHAPES)) {
+        BodyManager::DrawSettings settings;
+        settings.mDrawShape = true;
+        settings.mDrawShapeWireframe = true;
+        mCategory = DEBUG_DRAW_SHAPES;
+        physics.DrawBodies(settings, this);
+    }
+    if (IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_AABBS)) {
+        BodyManager::DrawSettings settings;
+        settings.mDrawShape = false;
+        settings.mDrawBoundingBox = true;
+        mCategory = DEBUG_DRAW_AABBS;
+        physics.DrawBodies(settings, this);
+    }
+    if (IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_CONSTRAINTS)) {
+        mCategory = DEBUG_DRAW_CONSTRAINTS;
+        physics.DrawConstraints(this);
+        physics.DrawConstraintLimits(this);
+    }
+    if (IsDebugDrawEnabled(&mDraw, DEBUG_DRAW_BROADPHASE)) {
+        // The quad tree nodes are not exposed, only the combined bounds
+        mCategory = DEBUG_DRAW_BROADPHASE;
+        DrawWireBox(physics.GetBounds(), Color::sYellow);
+    }
+}
+
+void JoltDebugRenderer::DrawLine(RVec3Arg inFrom, RVec3Arg inTo, ColorArg inColor) {
+    float from[3], to[3];
+    toFloat3(inFrom, from);
+    toFloat3(inTo, to);
+    if (mStepping) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        DebugDrawLine(&mDraw, mCategory, from, to, inColor.GetUInt32());
+    } else {
+        DebugDrawLine(&mDraw, mCategory, from, to, inColor.GetUInt32());
+    }
+}
+
+void JoltDebugRenderer::DrawTriangle(RVec3Arg inV1, RVec3Arg inV2, RVec3Arg inV3, ColorArg inColor, ECastShadow) {
+    float v1[3], v2[3], v3[3];
+    toFloat3(inV1, v1);
+    toFloat3(inV2, v2);
+    toFloat3(inV3, v3);
+    if (mStepping) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        DebugDrawTriangle(&mDraw, mCategory, v1, v2, v3, inColor.GetUInt32());
+    } else {
+        DebugDrawTriangle(&mDraw, mCategory, v1, v2, v3, inColor.GetUInt32());
+    }
+}
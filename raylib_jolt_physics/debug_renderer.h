@@ -0,0 +1,37 @@
+#pragma once
+
+// Jolt DebugRenderer writing into the shared batched DebugDraw buffers.
+// DebugRendererSimple turns Jolt's cached shape geometry into plain lines and
+// triangles, which are tagged with the category being drawn at the time.
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Renderer/DebugRendererSimple.h>
+
+#include <mutex>
+
+#include "debug_draw.h"
+
+class JoltDebugRenderer final : public JPH::DebugRendererSimple {
+public:
+    explicit JoltDebugRenderer(DebugDraw& draw) : mDraw(draw) {}
+
+    // Contact points are reported by the job threads during PhysicsSystem::Update
+    void BeginStep();
+    void EndStep();
+
+    // Shapes, bounding boxes, constraints and broadphase bounds, after the step
+    void DrawWorld(JPH::PhysicsSystem& physics, JPH::RVec3Arg cameraPosition);
+
+    virtual void DrawLine(JPH::RVec3Arg inFrom, JPH::RVec3Arg inTo, JPH::ColorArg inColor) override;
+    virtual void DrawTriangle(JPH::RVec3Arg inV1, JPH::RVec3Arg inV2, JPH::RVec3Arg inV3, JPH::ColorArg inColor,
+                              ECastShadow inCastShadow = ECastShadow::Off) override;
+    virtual void DrawText3D(JPH::RVec3Arg inPosition, const JPH::string_view& inString,
+                            JPH::ColorArg inColor = JPH::Color::sWhite, float inHeight = 0.5f) override {}
+
+private:
+    DebugDraw& mDraw;
+    unsigned int mCategory = DEBUG_DRAW_SHAPES;
+    bool mStepping = false;     // Lock mDraw, calls come from several threads
+    std::mutex mMutex;
+};
@@ -4,6 +4,8 @@
 #include <iomanip>
 #include <cmath>
 #include <random>
+#include <vector>
+#include <algorithm>
 
 #define WIN32_LEAN_AND_MEAN
 #define NOGDICAPMASKS
@@ -49,6 +51,7 @@
 namespace rl {
     #include "raylib.h"
     #include "raymath.h"
+    #include "terrain_model.h"
 }
 
 #include <Jolt/Jolt.h>
@@ -63,6 +66,17 @@ namespace rl {
 #include <Jolt/Physics/Collision/ObjectLayerPairFilterTable.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h>
 
+#include "body_state.h"
+#include "debug_draw.h"
+#include "debug_renderer.h"
+#include "demo_options.h"
+#include "net_server.h"
+#include "perf_timer.h"
+#include "shared_state.h"
+#include "step_profiler.h"
+#include "terrain_mesh.h"
+#include "terrain_cache.h"
+
 using namespace JPH;
 
 // Define physics layers
@@ -100,9 +114,61 @@ void JoltQuatToAxisAngle(JPH::Quat joltQuat, rl::Vector3& axis, float& angle) {
     angle = (180.0f / 3.14159265358979323846f) * angle; // Convert radians to degrees
 }
 
-int main() {
+// Space action: every cube back to its spawn point, at rest
+void ResetCubePositions(BodyInterface& body_interface, const std::vector<BodyID>& cube_ids) {
+    for (size_t i = 0; i < cube_ids.size(); i++) {
+        float spawn[3];
+        GetSpawnPosition((int)i, 10.0f, spawn);
+        body_interface.SetPosition(cube_ids[i], Vec3(spawn[0], spawn[1], spawn[2]), EActivation::Activate);
+        body_interface.SetLinearVelocity(cube_ids[i], Vec3(0.0f, 0.0f, 0.0f));
+    }
+}
+
+// R action: random angular velocity on every cube
+template <class Generator>
+void RandomizeCubeRotations(BodyInterface& body_interface, const std::vector<BodyID>& cube_ids,
+                            Generator& gen, std::uniform_real_distribution<float>& dist) {
+    for (const BodyID& id : cube_ids) {
+        body_interface.SetAngularVelocity(id, Vec3(dist(gen), dist(gen), dist(gen)));
+    }
+}
+
+// State handed to the simulation server (--server) and shared state (--shm) callbacks
+struct ServerContext {
+    PhysicsSystem* physics;
+    TempAllocator* temp_allocator;
+    JobSystem* job_system;
+    std::vector<BodyID>* cube_ids;
+    std::mt19937* gen;
+    std::uniform_real_distribution<float>* dist;
+    SharedStateWriter* shared_state;
+};
+
+// Transforms of the first count cubes, not called while stepping
+void GatherCubeStates(void* user, BodyState* states, int count) {
+    ServerContext* ctx = static_cast<ServerContext*>(user);
+    const BodyInterface& bodies = ctx->physics->GetBodyInterfaceNoLock();
+    for (int i = 0; i < count; i++) {
+        BodyID id = (*ctx->cube_ids)[i];
+        RVec3 position;
+        Quat rotation;
+        bodies.GetPositionAndRotation(id, position, rotation);
+        Vec3 half_extent = static_cast<const BoxShape*>(bodies.GetShape(id).GetPtr())->GetHalfExtent();
+        for (int k = 0; k < 3; k++) {
+            states[i].position[k] = (float)position[k];
+            states[i].rotation[k] = rotation.GetXYZ()[k];
+            states[i].halfExtents[k] = half_extent[k];
+        }
+        states[i].rotation[3] = rotation.GetW();
+    }
+}
+
+int main(int argc, char** argv) {
     std::cout << "Starting program...\n";
 
+    DemoOptions options;
+    ParseDemoOptions(&options, argc, argv);
+
     // Random number generator for rotation
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -114,25 +180,23 @@ int main() {
     JPH::RegisterTypes();
     std::cout << "Jolt initialized.\n";
 
-    // Initialize raylib
-    const int screenWidth = 800;
-    const int screenHeight = 600;
-    rl::InitWindow(screenWidth, screenHeight, "Cube Down Test - Mesh");
-    if (!rl::IsWindowReady()) {
-        std::cerr << "Failed to initialize window!\n";
-        return -1;
+    // Static terrain, generated here; in a real level this is the loaded asset
+    TerrainMesh terrain_mesh = { 0 };
+    if (options.terrainCells > 0 && !GenTerrainMesh(&terrain_mesh, options.terrainCells, 1.0f, 2.0f)) {
+        delete JPH::Factory::sInstance;
+        JPH::Factory::sInstance = nullptr;
+        JPH::UnregisterTypes();
+        return 1;
+    }
+
+    if (options.benchCookIterations > 0) {
+        RunTerrainCookBenchmark(terrain_mesh, options.benchCookIterations);
+        FreeTerrainMesh(&terrain_mesh);
+        delete JPH::Factory::sInstance;
+        JPH::Factory::sInstance = nullptr;
+        JPH::UnregisterTypes();
+        return 0;
     }
-    std::cout << "Window initialized.\n";
-    rl::SetTargetFPS(60);
-    rl::SetExitKey(0);
-
-    rl::Camera3D camera = { 0 };
-    camera.position = { 0.0f, 10.0f, 10.0f };
-    camera.target = { 0.0f, 0.0f, 0.0f };
-    camera.up = { 0.0f, 1.0f, 0.0f };
-    camera.fovy = 45.0f;
-    camera.projection = rl::CAMERA_PERSPECTIVE;
-    std::cout << "Camera initialized.\n";
 
     // Jolt systems
     TempAllocatorImpl temp_allocator(10 * 1024 * 1024);
@@ -150,12 +214,14 @@ int main() {
 
     ObjectVsBroadPhaseLayerFilterImpl object_vs_broadphase_filter;
 
+    // Limits grow with --bodies so large scenes fit
+    const uint body_count = (uint)options.bodyCount;
     PhysicsSystem physics;
     physics.Init(
-        1024,    // max bodies
-        1024,    // num body mutexes
-        65536,   // max body pairs
-        1024,    // max contact constraints
+        std::max(1024u, body_count + 16),      // max bodies
+        1024,                                  // num body mutexes
+        std::max(65536u, body_count * 8),      // max body pairs
+        std::max(1024u, body_count * 4),       // max contact constraints
         broad_phase_layer_interface,
         object_vs_broadphase_filter,
         object_layer_filter
@@ -174,6 +240,27 @@ int main() {
     BodyID floor_id = body_interface.CreateAndAddBody(floor_settings, EActivation::DontActivate);
     std::cout << "Floor created with ID: " << floor_id.GetIndexAndSequenceNumber() << "\n";
 
+    // Create terrain from the cooked cache (built and cooked on first run)
+    BodyID terrain_id;
+    rl::Model terrain_model = { 0 };
+    if (terrain_mesh.triangleCount > 0) {
+        double start = PerfNowSeconds();
+        TerrainCollision terrain;
+        if (LoadOrCookTerrain(terrain_mesh, terrain)) {
+            BodyCreationSettings terrain_settings(
+                terrain.shape.GetPtr(),
+                Vec3(0.0f, 0.0f, 0.0f),
+                Quat::sIdentity(),
+                EMotionType::Static,
+                Layers::NON_MOVING
+            );
+            terrain_id = body_interface.CreateAndAddBody(terrain_settings, EActivation::DontActivate);
+            std::cout << "Terrain created (" << terrain_mesh.triangleCount << " triangles, "
+                      << (terrain.fromCache ? "cooked" : "built") << ") in "
+                      << (PerfNowSeconds() - start) * 1000.0 << " ms\n";
+        }
+    }
+
     // Create cube
     BodyCreationSettings cube_settings(
         new BoxShape(Vec3(0.5f, 0.5f, 0.5f)),
@@ -187,80 +274,193 @@ int main() {
     BodyID cube_id = body_interface.CreateAndAddBody(cube_settings, EActivation::Activate);
     std::cout << "Cube created with ID: " << cube_id.GetIndexAndSequenceNumber() << "\n";
 
-    // Create mesh cube
-    rl::Mesh cube_mesh = rl::GenMeshCube(1.0f, 1.0f, 1.0f);
-    rl::Model cube_model = rl::LoadModelFromMesh(cube_mesh);
-    std::cout << "Cube mesh and model created.\n";
-
-    int frame_count = 0;
-    while (!rl::WindowShouldClose()) {
-        // Update physics
-        physics.Update(
-            1.0f / 60.0f,    // delta time
-            1,               // collision steps
-            &temp_allocator, // temp allocator
-            &job_system      // job system
-        );
-
-        // Get cube position and rotation from Jolt
-        Vec3 cube_pos = body_interface.GetCenterOfMassPosition(cube_id);
-        Quat cube_rot = body_interface.GetRotation(cube_id);
-        rl::Vector3 position = { cube_pos.GetX(), cube_pos.GetY(), cube_pos.GetZ() };
-        
-        // Convert Jolt quaternion to axis-angle for raylib
-        rl::Vector3 rotation_axis;
-        float rotation_angle;
-        JoltQuatToAxisAngle(cube_rot, rotation_axis, rotation_angle);
-
-        // Random rotation on 'R' key
-        if (rl::IsKeyPressed(rl::KEY_R)) {
-            Vec3 randomAngularVelocity(dist(gen), dist(gen), dist(gen));
-            body_interface.SetAngularVelocity(cube_id, randomAngularVelocity);
-            std::cout << "Random rotation applied: (" << randomAngularVelocity.GetX() << ", "
-                      << randomAngularVelocity.GetY() << ", " << randomAngularVelocity.GetZ() << ")\n";
+    // Extra cubes for --bodies, stacked above the demo cube
+    std::vector<BodyID> cube_ids = { cube_id };
+    for (uint i = 1; i < body_count; i++) {
+        float spawn[3];
+        GetSpawnPosition((int)i, 10.0f, spawn);
+        cube_settings.mPosition = RVec3(spawn[0], spawn[1], spawn[2]);
+        cube_ids.push_back(body_interface.CreateAndAddBody(cube_settings, EActivation::Activate));
+    }
+    if (body_count > 1) {
+        physics.OptimizeBroadPhase();
+        std::cout << "Created " << body_count - 1 << " extra cubes.\n";
+    }
+
+    // Out-of-process viewers (--shm), published after every step
+    SharedStateWriter shared_state = {};
+    if (options.sharedStateName && options.profileSteps == 0) {
+        OpenSharedStateWriter(&shared_state, options.sharedStateName, "Jolt", (int)cube_ids.size());
+    }
+    ServerContext context = { &physics, &temp_allocator, &job_system, &cube_ids, &gen, &dist, &shared_state };
+
+    // Headless: fixed number of steps with the per-phase breakdown
+    // or step at the server tick rate and stream state to viewers
+    int result = 0;
+    if (options.profileSteps > 0) {
+        RunStepProfile(physics, temp_allocator, job_system, options.profileSteps);
+    } else if (options.serverPort > 0) {
+        NetServerConfig config = { (uint16_t)options.serverPort, options.tickRate,
+                                   (uint32_t)options.serverBudget, (int)cube_ids.size() };
+        NetServerCallbacks callbacks;
+        callbacks.user = &context;
+        callbacks.step = [](void* user, float dt) {
+            ServerContext* ctx = static_cast<ServerContext*>(user);
+            ctx->physics->Update(dt, 1, ctx->temp_allocator, ctx->job_system);
+            PublishSharedState(ctx->shared_state, GatherCubeStates, ctx, (int)ctx->cube_ids->size());
+        };
+        callbacks.gather = GatherCubeStates;
+        callbacks.command = [](void* user, int command) {
+            ServerContext* ctx = static_cast<ServerContext*>(user);
+            if (command == NET_COMMAND_RESET) {
+                ResetCubePositions(ctx->physics->GetBodyInterface(), *ctx->cube_ids);
+            } else if (command == NET_COMMAND_RANDOMIZE) {
+                RandomizeCubeRotations(ctx->physics->GetBodyInterface(), *ctx->cube_ids, *ctx->gen, *ctx->dist);
+            }
+        };
+        result = RunNetServer(&config, &callbacks);
+    } else {
+        // Initialize raylib
+        const int screenWidth = 800;
+        const int screenHeight = 600;
+        rl::InitWindow(screenWidth, screenHeight, "Cube Down Test - Mesh");
+        if (!rl::IsWindowReady()) {
+            std::cerr << "Failed to initialize window!\n";
+            return -1;
+        }
+        std::cout << "Window initialized.\n";
+        rl::SetTargetFPS(60);
+        rl::SetExitKey(0);
+
+        rl::Camera3D camera = { 0 };
+        camera.position = { 0.0f, 10.0f, 10.0f };
+        camera.target = { 0.0f, 0.0f, 0.0f };
+        camera.up = { 0.0f, 1.0f, 0.0f };
+        camera.fovy = 45.0f;
+        camera.projection = rl::CAMERA_PERSPECTIVE;
+        std::cout << "Camera initialized.\n";
+
+        if (!terrain_id.IsInvalid()) {
+            terrain_model = rl::LoadTerrainModel(terrain_mesh.vertices, terrain_mesh.indices, terrain_mesh.triangleCount);
         }
 
-        // Position reset on 'Space' key
-        if (rl::IsKeyPressed(rl::KEY_SPACE)) {
-            body_interface.SetPosition(cube_id, Vec3(0.0f, 10.0f, 0.0f), EActivation::Activate);
-            body_interface.SetLinearVelocity(cube_id, Vec3(0.0f, 0.0f, 0.0f));
-            std::cout << "Cube position reset to (0, 10, 0)\n";
+        // Engine debug drawing, batched (F1..F5 toggle categories)
+        DebugDraw debug_draw;
+        InitDebugDraw(&debug_draw, options.debugDrawMax, (unsigned int)options.debugDrawCategories);
+        JoltDebugRenderer debug_renderer(debug_draw);
+
+        // Create mesh cube
+        rl::Mesh cube_mesh = rl::GenMeshCube(1.0f, 1.0f, 1.0f);
+        rl::Model cube_model = rl::LoadModelFromMesh(cube_mesh);
+        std::cout << "Cube mesh and model created.\n";
+
+        int frame_count = 0;
+        while (!rl::WindowShouldClose()) {
+            UpdateDebugDrawToggles(&debug_draw);
+            BeginDebugDraw(&debug_draw);
+
+            // Update physics
+            debug_renderer.BeginStep();
+            physics.Update(
+                1.0f / 60.0f,    // delta time
+                1,               // collision steps
+                &temp_allocator, // temp allocator
+                &job_system      // job system
+            );
+            debug_renderer.EndStep();
+            PublishSharedState(&shared_state, GatherCubeStates, &context, (int)cube_ids.size());
+            debug_renderer.DrawWorld(physics, RVec3(camera.position.x, camera.position.y, camera.position.z));
+
+            // Get cube position and rotation from Jolt
+            Vec3 cube_pos = body_interface.GetCenterOfMassPosition(cube_id);
+            Quat cube_rot = body_interface.GetRotation(cube_id);
+            rl::Vector3 position = { cube_pos.GetX(), cube_pos.GetY(), cube_pos.GetZ() };
+        
+            // Convert Jolt quaternion to axis-angle for raylib
+            rl::Vector3 rotation_axis;
+            float rotation_angle;
+            JoltQuatToAxisAngle(cube_rot, rotation_axis, rotation_angle);
+
+            // Random rotation on 'R' key
+            if (rl::IsKeyPressed(rl::KEY_R)) {
+                RandomizeCubeRotations(body_interface, cube_ids, gen, dist);
+                Vec3 randomAngularVelocity = body_interface.GetAngularVelocity(cube_id);
+                std::cout << "Random rotation applied: (" << randomAngularVelocity.GetX() << ", "
+                          << randomAngularVelocity.GetY() << ", " << randomAngularVelocity.GetZ() << ")\n";
+            }
+
+            // Position reset on 'Space' key
+            if (rl::IsKeyPressed(rl::KEY_SPACE)) {
+                ResetCubePositions(body_interface, cube_ids);
+                std::cout << "Cube position reset to (0, 10, 0)\n";
+            }
+
+            // Prepare position and rotation text
+            std::ostringstream pos_str, rot_str;
+            pos_str << std::fixed << std::setprecision(2) 
+                    << "Pos: (" << cube_pos.GetX() << ", " << cube_pos.GetY() << ", " << cube_pos.GetZ() << ")";
+            rot_str << std::fixed << std::setprecision(2) 
+                    << "Rot Axis: (" << rotation_axis.x << ", " << rotation_axis.y << ", " << rotation_axis.z 
+                    << "), Angle: " << rotation_angle << " deg";
+
+            std::cout << "Frame " << frame_count << ": " << pos_str.str() << ", " << rot_str.str() << "\n";
+
+            // Render
+            rl::BeginDrawing();
+            rl::ClearBackground(rl::RAYWHITE);
+
+            rl::BeginMode3D(camera);
+            rl::DrawCube({0.0f, -1.0f, 0.0f}, 200.0f, 2.0f, 200.0f, rl::GRAY); // Floor
+            if (!terrain_id.IsInvalid()) {
+                rl::DrawModel(terrain_model, {0.0f, 0.0f, 0.0f}, 1.0f, rl::WHITE); // Terrain
+            }
+            rl::DrawModelEx(cube_model, position, rotation_axis, rotation_angle, {1.0f, 1.0f, 1.0f}, rl::RED);
+            rl::DrawCubeWires(position, 1.0f, 1.0f, 1.0f, rl::BLACK); // Wireframe
+            // With shapes on the batched debug wireframes replace the per-body draw calls
+            for (size_t i = 1; i < cube_ids.size() && !IsDebugDrawEnabled(&debug_draw, DEBUG_DRAW_SHAPES); i++) {
+                RVec3 extra_pos;
+                Quat extra_rot;
+                body_interface.GetPositionAndRotation(cube_ids[i], extra_pos, extra_rot);
+                rl::Vector3 extra_axis;
+                float extra_angle;
+                JoltQuatToAxisAngle(extra_rot, extra_axis, extra_angle);
+                rl::Vector3 extra_position = { (float)extra_pos.GetX(), (float)extra_pos.GetY(), (float)extra_pos.GetZ() };
+                rl::DrawModelEx(cube_model, extra_position, extra_axis, extra_angle, {1.0f, 1.0f, 1.0f}, rl::ORANGE);
+                rl::DrawModelWiresEx(cube_model, extra_position, extra_axis, extra_angle, {1.0f, 1.0f, 1.0f}, rl::BLACK);
+            }
+            SubmitDebugDraw(&debug_draw);
+            rl::EndMode3D();
+
+            rl::DrawFPS(10, 10);
+            rl::DrawText("Cube Falling Test (Mesh)", 10, 40, 20, rl::BLACK);
+            rl::DrawText("Press R to randomize rotation", 10, 70, 20, rl::BLACK);
+            rl::DrawText("Press Space to reset position", 10, 100, 20, rl::BLACK);
+            rl::DrawText(pos_str.str().c_str(), 10, 130, 20, rl::BLACK); // Position text
+            rl::DrawText(rot_str.str().c_str(), 10, 160, 20, rl::BLACK); // Rotation text
+            DrawDebugDrawStats(&debug_draw, 10, 190);
+            rl::EndDrawing();
+
+            frame_count++;
         }
 
-        // Prepare position and rotation text
-        std::ostringstream pos_str, rot_str;
-        pos_str << std::fixed << std::setprecision(2) 
-                << "Pos: (" << cube_pos.GetX() << ", " << cube_pos.GetY() << ", " << cube_pos.GetZ() << ")";
-        rot_str << std::fixed << std::setprecision(2) 
-                << "Rot Axis: (" << rotation_axis.x << ", " << rotation_axis.y << ", " << rotation_axis.z 
-                << "), Angle: " << rotation_angle << " deg";
-
-        std::cout << "Frame " << frame_count << ": " << pos_str.str() << ", " << rot_str.str() << "\n";
-
-        // Render
-        rl::BeginDrawing();
-        rl::ClearBackground(rl::RAYWHITE);
-
-        rl::BeginMode3D(camera);
-        rl::DrawCube({0.0f, -1.0f, 0.0f}, 200.0f, 2.0f, 200.0f, rl::GRAY); // Floor
-        rl::DrawModelEx(cube_model, position, rotation_axis, rotation_angle, {1.0f, 1.0f, 1.0f}, rl::RED);
-        rl::DrawCubeWires(position, 1.0f, 1.0f, 1.0f, rl::BLACK); // Wireframe
-        rl::EndMode3D();
-
-        rl::DrawFPS(10, 10);
-        rl::DrawText("Cube Falling Test (Mesh)", 10, 40, 20, rl::BLACK);
-        rl::DrawText("Press R to randomize rotation", 10, 70, 20, rl::BLACK);
-        rl::DrawText("Press Space to reset position", 10, 100, 20, rl::BLACK);
-        rl::DrawText(pos_str.str().c_str(), 10, 130, 20, rl::BLACK); // Position text
-        rl::DrawText(rot_str.str().c_str(), 10, 160, 20, rl::BLACK); // Rotation text
-        rl::EndDrawing();
-
-        frame_count++;
+        // Cleanup
+        std::cout << "Cleaning up...\n";
+        rl::UnloadModel(cube_model);
+        if (!terrain_id.IsInvalid()) rl::UnloadModel(terrain_model);
+        UnloadDebugDraw(&debug_draw);
+        rl::CloseWindow();
     }
 
-    // Cleanup
-    std::cout << "Cleaning up...\n";
-    rl::UnloadModel(cube_model);
+    CloseSharedStateWriter(&shared_state);
+    for (size_t i = 1; i < cube_ids.size(); i++) {
+        body_interface.RemoveBody(cube_ids[i]);
+        body_interface.DestroyBody(cube_ids[i]);
+    }
+    if (!terrain_id.IsInvalid()) {
+        body_interface.RemoveBody(terrain_id);
+        body_interface.DestroyBody(terrain_id);
+    }
+    FreeTerrainMesh(&terrain_mesh);
     body_interface.RemoveBody(cube_id);
     body_interface.DestroyBody(cube_id);
     body_interface.RemoveBody(floor_id);
@@ -270,7 +470,7 @@ int main() {
     JPH::Factory::sInstance = nullptr;
     JPH::UnregisterTypes();
 
-    rl::CloseWindow();
+    if (options.profileSteps > 0 || options.serverPort > 0) return result;
     std::cout << "Program ended. Press enter to exit...\n";
     std::cin.get();
 
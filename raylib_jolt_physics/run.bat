@@ -1,3 +1,3 @@
 @echo off
 cd build/debug
-CubeDownTest.exe
\ No newline at end of file
+CubeDownTest.exe %*
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "step_profiler.h"
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+#include "perf_timer.h"
+#include "step_profile.h"
+
+using namespace JPH;
+
+#ifdef JPH_EXTERNAL_PROFILE
+
+namespace {
+
+// Job and function names used by PhysicsSystem::Update. FindCollisions runs
+// both broadphase pair finding and ProcessBodyPair, so it is left to its children.
+const StepPhaseRule joltRules[] = {
+    { "Broadphase", STEP_PHASE_BROADPHASE },
+    { "BroadPhase", STEP_PHASE_BROADPHASE },
+    { "FindCollidingPairs", STEP_PHASE_BROADPHASE },
+    { "ProcessBodyPair", STEP_PHASE_NARROWPHASE },
+    { "FindCCDContacts", STEP_PHASE_NARROWPHASE },
+    { "DetermineActiveConstraints", STEP_PHASE_CONSTRAINT_SETUP },
+    { "BuildIslands", STEP_PHASE_CONSTRAINT_SETUP },
+    { "FinalizeIslands", STEP_PHASE_CONSTRAINT_SETUP },
+    { "SetupVelocityConstraints", STEP_PHASE_CONSTRAINT_SETUP },
+    { "SolveVelocityConstraints", STEP_PHASE_SOLVE },
+    { "SolvePositionConstraints", STEP_PHASE_SOLVE },
+    { "ResolveCCDContacts", STEP_PHASE_SOLVE },
+    { "ApplyGravity", STEP_PHASE_INTEGRATE },
+    { "IntegrateVelocity", STEP_PHASE_INTEGRATE },
+};
+
+std::atomic<bool> sCollecting { false };
+std::atomic<int64_t> sPhaseNanos[STEP_PHASE_COUNT];
+
+// Scopes already inside a timed scope on this thread are not counted twice
+thread_local int tTimedDepth = 0;
+
+// Names are string literals, classify each one once per thread
+struct CachedScope {
+    const char* name;
+    StepPhase phase;
+};
+thread_local CachedScope tScopeCache[64];
+
+StepPhase classify(const char* name) {
+    CachedScope& slot = tScopeCache[(reinterpret_cast<uintptr_t>(name) >> 3) & 63];
+    if (slot.name != name) {
+        slot.name = name;
+        slot.phase = ClassifyStepScope(joltRules, (int)(sizeof(joltRules) / sizeof(joltRules[0])), name);
+    }
+    return slot.phase;
+}
+
+// Lives in ExternalProfileMeasurement::mUserData
+struct Measurement {
+    double start;
+    StepPhase phase;    // Phase being timed, NONE when this scope is not counted
+    bool matched;       // Holds a tTimedDepth level
+};
+static_assert(sizeof(Measurement) <= 64, "Measurement must fit ExternalProfileMeasurement::mUserData");
+
+} // namespace
+
+ExternalProfileMeasurement::ExternalProfileMeasurement(const char* inName, uint32 inColor) {
+    Measurement* measurement = new (mUserData) Measurement { 0.0, STEP_PHASE_NONE, false };
+    if (!inName || !sCollecting.load(std::memory_order_relaxed)) return;
+
+    StepPhase phase = classify(inName);
+    if (phase == STEP_PHASE_NONE) return;
+    measurement->matched = true;
+    if (tTimedDepth++ == 0) {
+        measurement->phase = phase;
+        measurement->start = PerfNowSeconds();
+    }
+}
+
+ExternalProfileMeasurement::~ExternalProfileMeasurement() {
+    Measurement* measurement = reinterpret_cast<Measurement*>(mUserData);
+    if (!measurement->matched) return;
+    tTimedDepth--;
+    if (measurement->phase != STEP_PHASE_NONE) {
+        int64_t nanos = (int64_t)((PerfNowSeconds() - measurement->start) * 1e9);
+        sPhaseNanos[measurement->phase].fetch_add(nanos, std::memory_order_relaxed);
+    }
+}
+
+#endif // JPH_EXTERNAL_PROFILE
+
+void RunStepProfile(PhysicsSystem& physics, TempAllocator& tempAllocator, JobSystem& jobSystem, int steps) {
+    StepProfile profile;
+#ifdef JPH_EXTERNAL_PROFILE
+    InitStepProfile(&profile, "Jolt", "JPH_PROFILE scopes, CPU time summed over the job threads", steps);
+#else
+    InitStepProfile(&profile, "Jolt", "nothing: configure with -DPHYSICS_PROFILE=ON for the phase times", steps);
+#endif
+
+    for (int i = 0; i < steps; i++) {
+#ifdef JPH_EXTERNAL_PROFILE
+        sCollecting.store(true, std::memory_order_relaxed);
+#endif
+        double start = PerfNowSeconds();
+        physics.Update(1.0f / 60.0f, 1, &tempAllocator, &jobSystem);
+        double wall = PerfNowSeconds() - start;
+#ifdef JPH_EXTERNAL_PROFILE
+        sCollecting.store(false, std::memory_order_relaxed);
+        for (int p = 0; p < STEP_PHASE_COUNT; p++) {
+            AddStepPhaseTime(&profile, (StepPhase)p, sPhaseNanos[p].exchange(0) * 1e-9);
+        }
+#endif
+        RecordProfiledStep(&profile, wall);
+    }
+
+    PrintStepProfile(&profile);
+    ExportStepProfile(&profile, "step_profile_jolt.csv");
+    UnloadStepProfile(&profile);
+}
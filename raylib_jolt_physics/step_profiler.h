@@ -0,0 +1,14 @@
+#pragma once
+
+// --profile for Jolt. With PHYSICS_PROFILE the library is built with
+// JPH_EXTERNAL_PROFILE and every JPH_PROFILE scope (job names included) lands
+// in ExternalProfileMeasurement, which times the outermost scope matching a
+// phase rule on each thread. Without it only the wall-clock step is reported.
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystem.h>
+#include <Jolt/Core/TempAllocator.h>
+#include <Jolt/Physics/PhysicsSystem.h>
+
+// Steps the scene, prints the phase table and writes step_profile_jolt.csv
+void RunStepProfile(JPH::PhysicsSystem& physics, JPH::TempAllocator& tempAllocator, JPH::JobSystem& jobSystem, int steps);
@@ -0,0 +1,146 @@
+#include "terrain_cache.h"
+
+#include <Jolt/Core/StreamIn.h>
+#include <Jolt/Core/StreamWrapper.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "perf_timer.h"
+
+using namespace JPH;
+
+namespace {
+
+// Binary state layout is only valid for the Jolt version that wrote it
+constexpr uint32 cJoltVersion = (JPH_VERSION_MAJOR << 16) | (JPH_VERSION_MINOR << 8) | JPH_VERSION_PATCH;
+
+// Reads straight out of the mapped cache file
+class MemoryStreamIn final : public StreamIn {
+public:
+    MemoryStreamIn(const void* data, size_t size) : mData(static_cast<const uint8*>(data)), mSize(size) {}
+
+    virtual void ReadBytes(void* outData, size_t inNumBytes) override {
+        if (inNumBytes > mSize - mPosition) {
+            mFailed = true;
+            mPosition = mSize;
+            return;
+        }
+        std::memcpy(outData, mData + mPosition, inNumBytes);
+        mPosition += inNumBytes;
+    }
+
+    virtual bool IsEOF() const override { return mPosition >= mSize; }
+    virtual bool IsFailed() const override { return mFailed; }
+
+private:
+    const uint8* mData;
+    size_t mSize;
+    size_t mPosition = 0;
+    bool mFailed = false;
+};
+
+std::string SaveShape(const Shape& shape) {
+    std::stringstream data(std::ios::out | std::ios::in | std::ios::binary);
+    StreamOutWrapper stream(data);
+    shape.SaveBinaryState(stream);
+    return data.str();
+}
+
+} // namespace
+
+ShapeRefC BuildTerrainShape(const TerrainMesh& mesh) {
+    VertexList vertices;
+    vertices.reserve(mesh.vertexCount);
+    for (int i = 0; i < mesh.vertexCount; i++) {
+        const float* v = &mesh.vertices[3 * i];
+        vertices.push_back(Float3(v[0], v[1], v[2]));
+    }
+
+    IndexedTriangleList triangles;
+    triangles.reserve(mesh.triangleCount);
+    for (int i = 0; i < mesh.triangleCount; i++) {
+        const uint32_t* t = &mesh.indices[3 * i];
+        triangles.push_back(IndexedTriangle(t[0], t[1], t[2], 0));
+    }
+
+    MeshShapeSettings settings(std::move(vertices), std::move(triangles));
+    ShapeSettings::ShapeResult result = settings.Create();
+    if (result.HasErrors()) {
+        std::cerr << "Terrain MeshShape failed: " << result.GetError() << "\n";
+        return nullptr;
+    }
+    return result.Get();
+}
+
+ShapeRefC RestoreTerrainShape(const CookedMesh& cooked) {
+    MemoryStreamIn stream(cooked.blob, cooked.blobSize);
+    Shape::ShapeResult result = Shape::sRestoreFromBinaryState(stream);
+    if (result.HasErrors() || stream.IsFailed()) {
+        std::cerr << "Terrain restore failed: " << (result.HasErrors() ? result.GetError().c_str() : "truncated blob") << "\n";
+        return nullptr;
+    }
+    return result.Get();
+}
+
+bool LoadOrCookTerrain(const TerrainMesh& mesh, TerrainCollision& terrain) {
+    uint64_t hash = HashTerrainMesh(&mesh, "jolt", cJoltVersion);
+    char path[COOKED_MESH_PATH_MAX];
+    GetCookedMeshPath(path, sizeof(path), "jolt", hash);
+
+    // MeshShape copies its tree out of the stream, so the mapping can go right away
+    CookedMesh cooked;
+    if (LoadCookedMesh(&cooked, path, hash)) {
+        terrain.shape = RestoreTerrainShape(cooked);
+        UnloadCookedMesh(&cooked);
+        if (terrain.shape != nullptr) {
+            terrain.fromCache = true;
+            return true;
+        }
+    }
+
+    terrain.fromCache = false;
+    terrain.shape = BuildTerrainShape(mesh);
+    if (terrain.shape == nullptr) return false;
+
+    std::string blob = SaveShape(*terrain.shape);
+    if (SaveCookedMesh(path, hash, &mesh, blob.data(), blob.size())) {
+        std::cout << "Terrain cooked to " << path << " (" << blob.size() << " bytes)\n";
+    }
+    return true;
+}
+
+void RunTerrainCookBenchmark(const TerrainMesh& mesh, int iterations) {
+    TerrainCollision warmup;
+    if (!LoadOrCookTerrain(mesh, warmup)) return;
+
+    uint64_t hash = HashTerrainMesh(&mesh, "jolt", cJoltVersion);
+    char path[COOKED_MESH_PATH_MAX];
+    GetCookedMeshPath(path, sizeof(path), "jolt", hash);
+
+    std::vector<double> buildSeconds(iterations), cookedSeconds(iterations);
+    for (int i = 0; i < iterations; i++) {
+        double start = PerfNowSeconds();
+        ShapeRefC built = BuildTerrainShape(mesh);
+        buildSeconds[i] = PerfNowSeconds() - start;
+
+        start = PerfNowSeconds();
+        CookedMesh cooked;
+        ShapeRefC restored;
+        if (LoadCookedMesh(&cooked, path, hash)) {
+            restored = RestoreTerrainShape(cooked);
+            UnloadCookedMesh(&cooked);
+        }
+        cookedSeconds[i] = PerfNowSeconds() - start;
+
+        if (built == nullptr || restored == nullptr) {
+            std::cerr << "Terrain benchmark aborted\n";
+            return;
+        }
+    }
+
+    ReportCookBenchmark("Jolt MeshShape", &mesh, buildSeconds.data(), cookedSeconds.data(), iterations);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Static terrain MeshShape: built from scratch, or restored from the cooked cache
+// written with Shape::SaveBinaryState so startup skips sanitizing and the BVH build.
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+
+#include "terrain_mesh.h"
+
+struct TerrainCollision {
+    JPH::ShapeRefC shape;
+    bool fromCache = false;
+};
+
+// Sanitizes the triangles and builds the mesh BVH
+JPH::ShapeRefC BuildTerrainShape(const TerrainMesh& mesh);
+
+// Restores a shape from a cooked blob, no tree build
+JPH::ShapeRefC RestoreTerrainShape(const CookedMesh& cooked);
+
+// Uses the cooked file for this mesh when present, otherwise builds and writes it
+bool LoadOrCookTerrain(const TerrainMesh& mesh, TerrainCollision& terrain);
+
+// Times both startup paths and prints the comparison
+void RunTerrainCookBenchmark(const TerrainMesh& mesh, int iterations);
@@ -0,0 +1,76 @@
+// Headless bench client: connects to a demo running with --server, sends a
+// randomize command every second and reports bytes per tick and latency.
+//
+//   net_bench [host] [port] [seconds] [budget bytes/tick]
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "net_client.h"
+#include "perf_timer.h"
+
+#define WAIT_SECONDS 0.01       // Longest block on the socket, keeps the command timer going
+
+int main(int argc, char **argv) {
+    const char *host = argc > 1 ? argv[1] : "127.0.0.1";
+    uint16_t port = (uint16_t)(argc > 2 ? atoi(argv[2]) : NET_DEFAULT_PORT);
+    double duration = argc > 3 ? atof(argv[3]) : 10.0;
+    uint32_t budget = (uint32_t)(argc > 4 ? atoi(argv[4]) : 0);
+
+    NetClient client;
+    if (!NetClientConnect(&client, host, port)) return 1;
+
+    // Same view as the demos' default camera in their 800x600 window
+    NetCameraPacket camera = {
+        .position = { 0.0f, 10.0f, 10.0f },
+        .forward = { 0.0f, -0.70710678f, -0.70710678f },
+        .horizontalFov = NetHorizontalFov(45.0f, 800.0f / 600.0f),
+        .viewDistance = 200.0f,
+        .budget = budget,
+    };
+    NetClientSetCamera(&client, &camera);
+    printf("Bench: %s:%u for %.0f s\n", host, port, duration);
+
+    double start = PerfNowSeconds();
+    double lastCommand = start;
+    while (PerfNowSeconds() - start < duration) {
+        NetClientUpdate(&client);
+
+        double now = PerfNowSeconds();
+        if (client.stats.ticks == 0 && now - start > 3.0) {
+            printf("Bench: no state from server\n");
+            NetClientDisconnect(&client);
+            return 1;
+        }
+        if (now - lastCommand >= 1.0) {
+            NetClientSendCommand(&client, NET_COMMAND_RANDOMIZE);
+            lastCommand = now;
+        }
+        // Blocks instead of polling: the bench shares the host with the server it measures,
+        // and a state packet wakes it at once so the latency stays exact
+        NetSocketWait(&client.socket, WAIT_SECONDS);
+    }
+
+    const NetClientStats *stats = &client.stats;
+    double elapsed = PerfNowSeconds() - start;
+    uint32_t span = stats->ticks ? stats->lastTick - stats->firstTick + 1 : 0;
+    double ticks = stats->ticks ? (double)stats->ticks : 1.0;
+    int known = 0;
+    for (int i = 0; i < client.bodyCount; i++) known += client.bodies[i].known;
+
+    printf("Ticks received    %u of %u (%u missed)\n", stats->ticks, span, span - stats->ticks);
+    printf("Bodies known      %d of %d\n", known, client.bodyCount);
+    printf("Bytes per tick    avg %.0f  max %u  (%.1f kB/s)\n",
+           (double)stats->bytes / ticks, stats->maxTickBytes, (double)stats->bytes / elapsed / 1024.0);
+    printf("Bodies per tick   avg %.1f  (%.1f packets/tick)\n",
+           (double)stats->entries / ticks, (double)stats->packets / ticks);
+    printf("Latency           p50 %.3f ms  p99 %.3f ms  max %.3f ms  (server step -> received)\n",
+           NetClientLatencyPercentile(&client, 50.0f), NetClientLatencyPercentile(&client, 99.0f),
+           NetClientLatencyPercentile(&client, 100.0f));
+    if (stats->commandRtts > 0) {
+        printf("Command round trip avg %.3f ms  max %.3f ms  over %u commands (sent -> applied state received)\n",
+               stats->commandRttSum / stats->commandRtts * 1000.0, stats->commandRttMax * 1000.0, stats->commandRtts);
+    }
+
+    NetClientDisconnect(&client);
+    return 0;
+}
@@ -0,0 +1,3 @@
+@echo off
+cd build/Debug
+net_viewer.exe %*
\ No newline at end of file
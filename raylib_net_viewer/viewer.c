@@ -0,0 +1,102 @@
+// Remote viewer for a demo running with --server: renders the bodies the
+// server streams and sends its camera so the server can prioritize what is in view.
+//
+//   net_viewer [host] [port] [budget bytes/tick]
+#include <stdio.h>
+#include <stdlib.h>
+#include "raylib.h"
+#include "raymath.h"
+#include "net_client.h"
+
+#define CAMERA_SEND_INTERVAL 0.1f
+#define STALE_TICKS (NET_REFRESH_TICKS + 30)    // A missed refresh, plus slack for budget starved ones
+
+static void sendCamera(NetClient *client, const Camera3D *camera, uint32_t budget) {
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera->target, camera->position));
+    NetCameraPacket packet = {
+        .position = { camera->position.x, camera->position.y, camera->position.z },
+        .forward = { forward.x, forward.y, forward.z },
+        .horizontalFov = NetHorizontalFov(camera->fovy, (float)GetScreenWidth() / (float)GetScreenHeight()),
+        .viewDistance = 200.0f,
+        .budget = budget,
+    };
+    NetClientSetCamera(client, &packet);
+}
+
+int main(int argc, char **argv) {
+    const char *host = argc > 1 ? argv[1] : "127.0.0.1";
+    uint16_t port = (uint16_t)(argc > 2 ? atoi(argv[2]) : NET_DEFAULT_PORT);
+    uint32_t budget = (uint32_t)(argc > 3 ? atoi(argv[3]) : 0);
+
+    NetClient client;
+    if (!NetClientConnect(&client, host, port)) return 1;
+
+    InitWindow(800, 600, "Simulation Viewer - R: Randomize, Space: Reset, RMB: Fly");
+    SetTargetFPS(60);
+
+    Camera3D camera = { 0 };
+    camera.position = (Vector3){ 0.0f, 10.0f, 10.0f };
+    camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };
+    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 45.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    Model cube_model = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
+    float camera_timer = CAMERA_SEND_INTERVAL;
+
+    while (!WindowShouldClose()) {
+        if (IsMouseButtonDown(MOUSE_BUTTON_RIGHT)) UpdateCamera(&camera, CAMERA_FREE);
+        if (IsKeyPressed(KEY_R)) NetClientSendCommand(&client, NET_COMMAND_RANDOMIZE);
+        if (IsKeyPressed(KEY_SPACE)) NetClientSendCommand(&client, NET_COMMAND_RESET);
+
+        camera_timer += GetFrameTime();
+        if (camera_timer >= CAMERA_SEND_INTERVAL) {
+            sendCamera(&client, &camera, budget);
+            camera_timer = 0.0f;
+        }
+        NetClientUpdate(&client);
+
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+        BeginMode3D(camera);
+
+        DrawPlane((Vector3){ 0, 0, 0 }, (Vector2){ 10, 10 }, GRAY);
+        int known = 0;
+        for (int i = 0; i < client.bodyCount; i++) {
+            const NetBodyView *body = &client.bodies[i];
+            if (!body->known) continue;
+            known++;
+
+            Quaternion q = { body->rotation[0], body->rotation[1], body->rotation[2], body->rotation[3] };
+            Matrix scale = MatrixScale(body->halfExtents[0] * 2.0f, body->halfExtents[1] * 2.0f, body->halfExtents[2] * 2.0f);
+            Matrix translate = MatrixTranslate(body->position[0], body->position[1], body->position[2]);
+            cube_model.transform = MatrixMultiply(MatrixMultiply(scale, QuaternionToMatrix(q)), translate);
+
+            // Bodies the server skipped a whole refresh cycle for are out of interest or starved by the budget
+            bool stale = client.latestTick - body->tick > STALE_TICKS;
+            DrawModel(cube_model, (Vector3){ 0, 0, 0 }, 1.0f, stale ? LIGHTGRAY : RED);
+            DrawModelWires(cube_model, (Vector3){ 0, 0, 0 }, 1.0f, BLACK);
+        }
+
+        EndMode3D();
+
+        const NetClientStats *stats = &client.stats;
+        DrawFPS(10, 10);
+        DrawText("R: Randomize  Space: Reset  Hold RMB: Fly camera", 10, 30, 20, DARKGRAY);
+        DrawText(TextFormat("Server %s:%u  tick %u", host, port, client.latestTick), 10, 60, 20, DARKGRAY);
+        DrawText(TextFormat("Bodies: %d of %d known", known, client.bodyCount), 10, 90, 20, DARKGRAY);
+        DrawText(TextFormat("Received: %.1f kB, %llu packets", (double)stats->bytes / 1024.0,
+                            (unsigned long long)stats->packets), 10, 120, 20, DARKGRAY);
+        if (stats->latencyCount > 0) {
+            DrawText(TextFormat("Latency: %.2f ms", stats->latencies[stats->latencyCount - 1]), 10, 150, 20, DARKGRAY);
+        }
+        if (client.commandPending) DrawText("Command pending...", 10, 180, 20, MAROON);
+
+        EndDrawing();
+    }
+
+    UnloadModel(cube_model);
+    CloseWindow();
+    NetClientDisconnect(&client);
+    return 0;
+}
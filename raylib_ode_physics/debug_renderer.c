@@ -0,0 +1,232 @@
+#include "debug_renderer.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+typedef struct HashCell {
+    int level;
+    int x, y, z;
+} HashCell;
+
+typedef struct CellList {
+    HashCell *cells;
+    int count;
+    int capacity;
+    bool failed;        // Out of memory, the cells are dropped for this frame
+} CellList;
+
+static void toFloat3(const dReal *v, float out[3]) {
+    out[0] = (float)v[0];
+    out[1] = (float)v[1];
+    out[2] = (float)v[2];
+}
+
+static uint32_t geomColor(dGeomID geom) {
+    dBodyID body = dGeomGetBody(geom);
+    if (!body) return DEBUG_DRAW_RGBA(90, 90, 90, 255);
+    return dBodyIsEnabled(body) ? DEBUG_DRAW_RGBA(0, 160, 0, 255) : DEBUG_DRAW_RGBA(150, 150, 150, 255);
+}
+
+static bool aabbIsFinite(const dReal aabb[6]) {
+    for (int i = 0; i < 6; i++) {
+        if (!isfinite(aabb[i]) || fabs(aabb[i]) > 1e6) return false;
+    }
+    return true;
+}
+
+static void drawShape(DebugDraw *draw, dGeomID geom) {
+    uint32_t color = geomColor(geom);
+    switch (dGeomGetClass(geom)) {
+        case dBoxClass: {
+            dVector3 lengths;
+            dGeomBoxGetLengths(geom, lengths);
+            const dReal *pos = dGeomGetPosition(geom);
+            const dReal *rot = dGeomGetRotation(geom);   // Row major 3x4
+            float center[3], half[3], axes[9];
+            toFloat3(pos, center);
+            for (int k = 0; k < 3; k++) {
+                half[k] = (float)lengths[k] * 0.5f;
+                for (int row = 0; row < 3; row++) axes[3 * k + row] = (float)rot[4 * row + k];
+            }
+            DebugDrawOrientedBox(draw, DEBUG_DRAW_SHAPES, center, axes, half, color);
+            break;
+        }
+        case dTriMeshClass: {
+            int count = dGeomTriMeshGetTriangleCount(geom);
+            for (int i = 0; i < count; i++) {
+                dVector3 v0, v1, v2;
+                dGeomTriMeshGetTriangle(geom, i, &v0, &v1, &v2);
+                float a[3], b[3], c[3];
+                toFloat3(v0, a);
+                toFloat3(v1, b);
+                toFloat3(v2, c);
+                DebugDrawLine(draw, DEBUG_DRAW_SHAPES, a, b, color);
+                DebugDrawLine(draw, DEBUG_DRAW_SHAPES, b, c, color);
+                DebugDrawLine(draw, DEBUG_DRAW_SHAPES, c, a, color);
+            }
+            break;
+        }
+        case dPlaneClass: {
+            // Infinite, outline a patch around the origin
+            dVector4 plane;
+            dGeomPlaneGetParams(geom, plane);
+            if (fabs(plane[1]) < 0.99) break;
+            float y = (float)(plane[3] / plane[1]);
+            float min[3] = { -10.0f, y, -10.0f };
+            float max[3] = { 10.0f, y, 10.0f };
+            DebugDrawBox(draw, DEBUG_DRAW_SHAPES, min, max, color);
+            break;
+        }
+        default: {
+            dReal aabb[6];
+            dGeomGetAABB(geom, aabb);
+            if (!aabbIsFinite(aabb)) break;
+            float min[3] = { (float)aabb[0], (float)aabb[2], (float)aabb[4] };
+            float max[3] = { (float)aabb[1], (float)aabb[3], (float)aabb[5] };
+            DebugDrawBox(draw, DEBUG_DRAW_SHAPES, min, max, color);
+            break;
+        }
+    }
+}
+
+// Joints other than contacts, drawn once from their first body
+static void drawJoints(DebugDraw *draw, dBodyID body) {
+    const uint32_t color = DEBUG_DRAW_RGBA(0, 0, 255, 255);
+    for (int i = 0; i < dBodyGetNumJoints(body); i++) {
+        dJointID joint = dBodyGetJoint(body, i);
+        if (dJointGetType(joint) == dJointTypeContact || dJointGetBody(joint, 0) != body) continue;
+
+        float a[3], b[3];
+        toFloat3(dBodyGetPosition(body), a);
+        dBodyID other = dJointGetBody(joint, 1);
+        dVector3 anchor;
+        switch (dJointGetType(joint)) {
+            case dJointTypeBall: dJointGetBallAnchor(joint, anchor); break;
+            case dJointTypeHinge: dJointGetHingeAnchor(joint, anchor); break;
+            default: {
+                const dReal *end = other ? dBodyGetPosition(other) : dBodyGetPosition(body);
+                anchor[0] = end[0];
+                anchor[1] = end[1];
+                anchor[2] = end[2];
+                break;
+            }
+        }
+        toFloat3(anchor, b);
+        DebugDrawLine(draw, DEBUG_DRAW_CONSTRAINTS, a, b, color);
+        if (other) {
+            toFloat3(dBodyGetPosition(other), a);
+            DebugDrawLine(draw, DEBUG_DRAW_CONSTRAINTS, b, a, color);
+        }
+    }
+}
+
+// Same cell assignment as dxHashSpace: the level comes from the largest AABB
+// side, geoms above maxlevel are not hashed and only tested brute force
+static void collectHashCells(CellList *list, dGeomID geom, int minLevel, int maxLevel) {
+    if (list->failed) return;
+    dReal aabb[6];
+    dGeomGetAABB(geom, aabb);
+    if (!aabbIsFinite(aabb)) return;
+
+    dReal size = 0;
+    for (int k = 0; k < 3; k++) {
+        if (aabb[2 * k + 1] - aabb[2 * k] > size) size = aabb[2 * k + 1] - aabb[2 * k];
+    }
+    int level;
+    frexp(size, &level);    // size = (0.5 .. 1) * 2^level, as ODE's findLevel
+    if (level < minLevel) level = minLevel;
+    if (level > maxLevel) return;
+
+    double cell = ldexp(1.0, level);
+    int lo[3], hi[3];
+    for (int k = 0; k < 3; k++) {
+        lo[k] = (int)floor(aabb[2 * k] / cell);
+        hi[k] = (int)floor(aabb[2 * k + 1] / cell);
+    }
+    for (int x = lo[0]; x <= hi[0]; x++) {
+        for (int y = lo[1]; y <= hi[1]; y++) {
+            for (int z = lo[2]; z <= hi[2]; z++) {
+                if (list->count == list->capacity) {
+                    int capacity = list->capacity ? list->capacity * 2 : 4096;
+                    HashCell *cells = (HashCell *)realloc(list->cells, sizeof(HashCell) * (size_t)capacity);
+                    if (!cells) {
+                        list->failed = true;
+                        return;
+                    }
+                    list->cells = cells;
+                    list->capacity = capacity;
+                }
+                list->cells[list->count++] = (HashCell){ level, x, y, z };
+            }
+        }
+    }
+}
+
+static int compareCells(const void *a, const void *b) {
+    const HashCell *ca = (const HashCell *)a;
+    const HashCell *cb = (const HashCell *)b;
+    if (ca->level != cb->level) return ca->level < cb->level ? -1 : 1;
+    if (ca->x != cb->x) return ca->x < cb->x ? -1 : 1;
+    if (ca->y != cb->y) return ca->y < cb->y ? -1 : 1;
+    if (ca->z != cb->z) return ca->z < cb->z ? -1 : 1;
+    return 0;
+}
+
+static void drawHashCells(DebugDraw *draw, CellList *list) {
+    if (list->failed) return;
+    qsort(list->cells, (size_t)list->count, sizeof(HashCell), compareCells);
+    for (int i = 0; i < list->count; i++) {
+        if (i > 0 && compareCells(&list->cells[i], &list->cells[i - 1]) == 0) continue;
+
+        const HashCell *c = &list->cells[i];
+        float size = (float)ldexp(1.0, c->level);
+        float min[3] = { c->x * size, c->y * size, c->z * size };
+        float max[3] = { min[0] + size, min[1] + size, min[2] + size };
+        DebugDrawBox(draw, DEBUG_DRAW_BROADPHASE, min, max, DEBUG_DRAW_RGBA(220, 180, 0, 160));
+    }
+}
+
+void DrawOdeSpace(DebugDraw *draw, dSpaceID space) {
+    unsigned int categories = DEBUG_DRAW_SHAPES | DEBUG_DRAW_AABBS | DEBUG_DRAW_CONSTRAINTS | DEBUG_DRAW_BROADPHASE;
+    if (!IsDebugDrawEnabled(draw, categories)) return;
+
+    int minLevel = 0, maxLevel = 0;
+    bool hashed = dSpaceGetClass(space) == dHashSpaceClass && IsDebugDrawEnabled(draw, DEBUG_DRAW_BROADPHASE);
+    if (hashed) dHashSpaceGetLevels(space, &minLevel, &maxLevel);
+    CellList cells = { 0 };
+
+    int count = dSpaceGetNumGeoms(space);
+    for (int i = 0; i < count; i++) {
+        dGeomID geom = dSpaceGetGeom(space, i);
+        if (dGeomIsSpace(geom)) {
+            DrawOdeSpace(draw, (dSpaceID)geom);
+            continue;
+        }
+
+        if (IsDebugDrawEnabled(draw, DEBUG_DRAW_SHAPES)) drawShape(draw, geom);
+        if (IsDebugDrawEnabled(draw, DEBUG_DRAW_AABBS)) {
+            dReal aabb[6];
+            dGeomGetAABB(geom, aabb);
+            if (aabbIsFinite(aabb)) {
+                float min[3] = { (float)aabb[0], (float)aabb[2], (float)aabb[4] };
+                float max[3] = { (float)aabb[1], (float)aabb[3], (float)aabb[5] };
+                DebugDrawBox(draw, DEBUG_DRAW_AABBS, min, max, DEBUG_DRAW_RGBA(255, 0, 255, 255));
+            }
+        }
+        dBodyID body = dGeomGetBody(geom);
+        if (body && IsDebugDrawEnabled(draw, DEBUG_DRAW_CONSTRAINTS)) drawJoints(draw, body);
+        if (hashed) collectHashCells(&cells, geom, minLevel, maxLevel);
+    }
+
+    if (hashed) {
+        drawHashCells(draw, &cells);
+        free(cells.cells);
+    }
+}
+
+void DrawOdeContact(DebugDraw *draw, const dContactGeom *contact) {
+    float point[3], normal[3];
+    toFloat3(contact->pos, point);
+    toFloat3(contact->normal, normal);
+    DebugDrawContact(draw, point, normal, DEBUG_DRAW_RGBA(230, 41, 55, 255));
+}
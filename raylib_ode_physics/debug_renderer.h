@@ -0,0 +1,16 @@
+#ifndef DEBUG_RENDERER_H
+#define DEBUG_RENDERER_H
+
+// ODE has no debug renderer: the space is walked here and written into the
+// shared batched DebugDraw buffers. Contacts are only known inside the
+// collision callback, nearCallback hands them over as they are generated.
+
+#include "ode/ode.h"
+#include "debug_draw.h"
+
+// Shapes, AABBs, joints and hash space cells for everything in the space
+void DrawOdeSpace(DebugDraw *draw, dSpaceID space);
+
+void DrawOdeContact(DebugDraw *draw, const dContactGeom *contact);
+
+#endif // DEBUG_RENDERER_H
@@ -1,8 +1,22 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
+#include <time.h>
 #include "raylib.h"
 #include "raymath.h" // Added for Matrix functions
 #include "ode/ode.h"
+#include "body_state.h"
+#include "debug_draw.h"
+#include "debug_renderer.h"
+#include "demo_options.h"
+#include "net_server.h"
+#include "perf_timer.h"
+#include "shared_state.h"
+#include "step_profile.h"
+#include "terrain_cache.h"
+#include "terrain_model.h"
+
+#define MAX_CONTACTS 4
 
 // Physics objects
 dWorldID world;
@@ -10,24 +24,45 @@ dSpaceID space;
 dGeomID ground;
 dBodyID cube_body;
 dGeomID cube_geom;
+dBodyID *bodies;        // bodies[0] is cube_body, the rest come from --bodies
+int body_count;
 dJointGroupID contact_group;
+dGeomID terrain_geom;
+
+// Out-of-process viewers (--shm), published after every step when open
+static SharedStateWriter shared_state;
+
+// Set while --profile runs, nearCallback then times dCollide and the contact joints
+static StepProfile *step_profile;
 
-// Callback for collision detection
+// Callback for collision detection, data is the DebugDraw when contacts are shown
 static void nearCallback(void *data, dGeomID o1, dGeomID o2) {
     dBodyID b1 = dGeomGetBody(o1);
     dBodyID b2 = dGeomGetBody(o2);
+    if (!b1 && !b2) return; // Static vs static (ground plane vs terrain)
     if (b1 && b2 && dAreConnected(b1, b2)) return;
 
-    dContact contact;
-    contact.surface.mode = dContactBounce;
-    contact.surface.mu = dInfinity; // Friction
-    contact.surface.bounce = 0.5;   // Bounciness
-    contact.surface.bounce_vel = 0.1;
-    contact.surface.soft_cfm = 0.01;
+    // Resting on triangles needs more than the single contact a plane gets away with
+    dContact contacts[MAX_CONTACTS];
+    for (int i = 0; i < MAX_CONTACTS; i++) {
+        contacts[i].surface.mode = dContactBounce;
+        contacts[i].surface.mu = dInfinity; // Friction
+        contacts[i].surface.bounce = 0.5;   // Bounciness
+        contacts[i].surface.bounce_vel = 0.1;
+        contacts[i].surface.soft_cfm = 0.01;
+    }
 
-    if (dCollide(o1, o2, 1, &contact.geom, sizeof(dContact))) {
-        dJointID c = dJointCreateContact(world, contact_group, &contact);
+    double collide_start = step_profile ? PerfNowSeconds() : 0.0;
+    int count = dCollide(o1, o2, MAX_CONTACTS, &contacts[0].geom, sizeof(dContact));
+    double collide_end = step_profile ? PerfNowSeconds() : 0.0;
+    for (int i = 0; i < count; i++) {
+        dJointID c = dJointCreateContact(world, contact_group, &contacts[i]);
         dJointAttach(c, b1, b2);
+        if (data) DrawOdeContact((DebugDraw *)data, &contacts[i].geom);
+    }
+    if (step_profile) {
+        AddStepPhaseTime(step_profile, STEP_PHASE_NARROWPHASE, collide_end - collide_start);
+        AddStepPhaseTime(step_profile, STEP_PHASE_CONSTRAINT_SETUP, PerfNowSeconds() - collide_end);
     }
 }
 
@@ -41,6 +76,93 @@ void resetCubePosition(dBodyID body) {
     dBodySetAngularVel(body, 0, 0, 0);
 }
 
+// Put every body back at its spawn point; randomize also throws the
+// demo cube somewhere random and gives the others a random orientation
+void resetBodies(int randomize) {
+    for (int i = 0; i < body_count; i++) {
+        if (i == 0 && randomize) {
+            resetCubePosition(bodies[0]);
+            continue;
+        }
+        float spawn[3];
+        GetSpawnPosition(i, 10.0f, spawn);
+        dBodySetPosition(bodies[i], spawn[0], spawn[1], spawn[2]);
+        dBodySetLinearVel(bodies[i], 0, 0, 0);
+        dBodySetAngularVel(bodies[i], 0, 0, 0);
+
+        dMatrix3 R;
+        if (randomize) {
+            dRFromAxisAndAngle(R, GetRandomValue(-100, 100), GetRandomValue(-100, 100), GetRandomValue(-100, 100) + 0.5,
+                               GetRandomValue(0, 628) * 0.01);
+        } else {
+            dRSetIdentity(R);
+        }
+        dBodySetRotation(bodies[i], R);
+    }
+}
+
+static void stepWorld(float dt, DebugDraw *debug) {
+    dSpaceCollide(space, debug && IsDebugDrawEnabled(debug, DEBUG_DRAW_CONTACTS) ? debug : NULL, &nearCallback);
+    dWorldQuickStep(world, dt);
+    dJointGroupEmpty(contact_group);
+}
+
+// --profile: dSpaceCollide and dWorldQuickStep timed separately. ODE has no
+// hooks inside the quick step, so its solve includes the integration.
+static void runStepProfile(int steps) {
+    StepProfile profile;
+    InitStepProfile(&profile, "ODE", "dSpaceCollide, dCollide and dWorldQuickStep timers (solve includes integration)", steps);
+    step_profile = &profile;
+
+    for (int i = 0; i < steps; i++) {
+        double start = PerfNowSeconds();
+        dSpaceCollide(space, NULL, &nearCallback);
+        double collided = PerfNowSeconds();
+        dWorldQuickStep(world, 1.0f / 60.0f);
+        double stepped = PerfNowSeconds();
+        dJointGroupEmpty(contact_group);    // Contact teardown, left to "other"
+        double end = PerfNowSeconds();
+
+        // What dSpaceCollide spent outside the near callback timings is the hash space pair search
+        double in_callback = profile.phases[STEP_PHASE_NARROWPHASE] + profile.phases[STEP_PHASE_CONSTRAINT_SETUP];
+        AddStepPhaseTime(&profile, STEP_PHASE_BROADPHASE, collided - start - in_callback);
+        AddStepPhaseTime(&profile, STEP_PHASE_SOLVE, stepped - collided);
+        RecordProfiledStep(&profile, end - start);
+    }
+
+    step_profile = NULL;
+    PrintStepProfile(&profile);
+    ExportStepProfile(&profile, "step_profile_ode.csv");
+    UnloadStepProfile(&profile);
+}
+
+// Simulation server (--server) and shared state (--shm) glue
+static void serverGather(void *user, BodyState *states, int count) {
+    (void)user;
+    for (int i = 0; i < count; i++) {
+        const dReal *pos = dBodyGetPosition(bodies[i]);
+        const dReal *q = dBodyGetQuaternion(bodies[i]); // w, x, y, z
+        dVector3 lengths;
+        dGeomBoxGetLengths(dBodyGetFirstGeom(bodies[i]), lengths);
+        for (int k = 0; k < 3; k++) {
+            states[i].position[k] = (float)pos[k];
+            states[i].rotation[k] = (float)q[k + 1];
+            states[i].halfExtents[k] = (float)lengths[k] * 0.5f;
+        }
+        states[i].rotation[3] = (float)q[0];
+    }
+}
+
+static void serverStep(void *user, float dt) {
+    stepWorld(dt, NULL);
+    PublishSharedState(&shared_state, serverGather, user, body_count);
+}
+
+static void serverCommand(void *user, int command) {
+    (void)user;
+    resetBodies(command == NET_COMMAND_RANDOMIZE);
+}
+
 // Convert ODE rotation matrix to yaw, pitch, roll (in degrees)
 void getYawPitchRoll(const dReal *rot, float *yaw, float *pitch, float *roll) {
     float r11 = rot[0], r12 = rot[4], r13 = rot[8];
@@ -52,9 +174,27 @@ void getYawPitchRoll(const dReal *rot, float *yaw, float *pitch, float *roll) {
     *roll = atan2f(r32, r33) * RAD2DEG;
 }
 
-int main() {
+int main(int argc, char **argv) {
+    DemoOptions options;
+    ParseDemoOptions(&options, argc, argv);
+
     // Initialize ODE
     dInitODE();
+
+    // Static terrain, generated here; in a real level this is the loaded asset
+    TerrainMesh terrain_mesh = { 0 };
+    if (options.terrainCells > 0 && !GenTerrainMesh(&terrain_mesh, options.terrainCells, 1.0f, 2.0f)) {
+        dCloseODE();
+        return 1;
+    }
+
+    if (options.benchCookIterations > 0) {
+        RunTerrainCookBenchmark(&terrain_mesh, options.benchCookIterations);
+        FreeTerrainMesh(&terrain_mesh);
+        dCloseODE();
+        return 0;
+    }
+
     world = dWorldCreate();
     space = dHashSpaceCreate(0);
     contact_group = dJointGroupCreate(0);
@@ -63,6 +203,16 @@ int main() {
     // Create ground plane
     ground = dCreatePlane(space, 0, 1, 0, 0);
 
+    // Create terrain from the cooked cache (built and cooked on first run)
+    TerrainCollision terrain = { 0 };
+    if (terrain_mesh.triangleCount > 0) {
+        double start = PerfNowSeconds();
+        LoadOrCookTerrain(&terrain_mesh, &terrain);
+        terrain_geom = dCreateTriMesh(space, terrain.data, NULL, NULL, NULL);
+        printf("Terrain created (%d triangles, %s) in %.2f ms\n", terrain_mesh.triangleCount,
+               terrain.fromCache ? "cooked" : "built", (PerfNowSeconds() - start) * 1000.0);
+    }
+
     // Define cube size
     const float cube_size = 1.0f;
 
@@ -73,8 +223,51 @@ int main() {
     dBodySetMass(cube_body, &mass);
     cube_geom = dCreateBox(space, cube_size, cube_size, cube_size);
     dGeomSetBody(cube_geom, cube_body);
+
+    // Extra cubes for --bodies, stacked above the demo cube
+    body_count = options.bodyCount;
+    bodies = (dBodyID *)malloc(sizeof(dBodyID) * (size_t)body_count);
+    bodies[0] = cube_body;
+    for (int i = 1; i < body_count; i++) {
+        bodies[i] = dBodyCreate(world);
+        dBodySetMass(bodies[i], &mass);
+        dGeomSetBody(dCreateBox(space, cube_size, cube_size, cube_size), bodies[i]);
+    }
+    resetBodies(0);
     resetCubePosition(cube_body);
 
+    if (options.sharedStateName && options.profileSteps == 0) {
+        OpenSharedStateWriter(&shared_state, options.sharedStateName, "ODE", body_count);
+    }
+
+    // Headless: fixed number of steps with the per-phase breakdown
+    // or step at the server tick rate and stream state to viewers
+    if (options.profileSteps > 0 || options.serverPort > 0) {
+        int result = 0;
+        if (options.profileSteps > 0) {
+            runStepProfile(options.profileSteps);
+        } else {
+            SetRandomSeed((unsigned int)time(NULL));
+            NetServerConfig config = { (uint16_t)options.serverPort, options.tickRate,
+                                       (uint32_t)options.serverBudget, body_count };
+            NetServerCallbacks callbacks = { NULL, serverStep, serverGather, serverCommand };
+            result = RunNetServer(&config, &callbacks);
+        }
+
+        CloseSharedStateWriter(&shared_state);
+        if (terrain_geom) {
+            dGeomDestroy(terrain_geom);
+            DestroyTerrain(&terrain);
+        }
+        FreeTerrainMesh(&terrain_mesh);
+        free(bodies);
+        dJointGroupDestroy(contact_group);
+        dSpaceDestroy(space);
+        dWorldDestroy(world);
+        dCloseODE();
+        return result;
+    }
+
     // Initialize Raylib
     InitWindow(800, 600, "Cube Drop Simulation (ODE) - Press R to Reset");
     SetTargetFPS(60);
@@ -86,18 +279,28 @@ int main() {
     camera.fovy = 45.0f;
     camera.projection = CAMERA_PERSPECTIVE;
 
+    // Engine debug drawing, batched (F1..F5 toggle categories)
+    DebugDraw debug_draw;
+    InitDebugDraw(&debug_draw, options.debugDrawMax, (unsigned int)options.debugDrawCategories);
+
     Model cube_model = LoadModelFromMesh(GenMeshCube(cube_size, cube_size, cube_size));
+    Model terrain_model = { 0 };
+    if (terrain_geom) {
+        terrain_model = LoadTerrainModel(terrain_mesh.vertices, terrain_mesh.indices, terrain_mesh.triangleCount);
+    }
     SetRandomSeed((unsigned int)GetTime());
 
     // Main loop
     while (!WindowShouldClose()) {
         if (IsKeyPressed(KEY_R)) {
-            resetCubePosition(cube_body);
+            resetBodies(1);
         }
 
-        dSpaceCollide(space, 0, &nearCallback);
-        dWorldQuickStep(world, 1.0 / 60.0);
-        dJointGroupEmpty(contact_group);
+        UpdateDebugDrawToggles(&debug_draw);
+        BeginDebugDraw(&debug_draw);
+        stepWorld(1.0f / 60.0f, &debug_draw);
+        PublishSharedState(&shared_state, serverGather, NULL, body_count);
+        DrawOdeSpace(&debug_draw, space);
 
         const dReal *pos = dBodyGetPosition(cube_body);
         const dReal *rot = dBodyGetRotation(cube_body);
@@ -134,9 +337,25 @@ int main() {
         BeginMode3D(camera);
 
         DrawPlane((Vector3){0, 0, 0}, (Vector2){10, 10}, GRAY);
+        if (terrain_geom) DrawModel(terrain_model, (Vector3){0, 0, 0}, 1.0f, WHITE);
         DrawModel(cube_model, (Vector3){0, 0, 0}, 1.0f, RED);
         DrawModelWires(cube_model, (Vector3){0, 0, 0}, 1.0f, BLACK);
+        // With shapes on the batched debug wireframes replace the per-body draw calls
+        for (int i = 1; i < body_count && !IsDebugDrawEnabled(&debug_draw, DEBUG_DRAW_SHAPES); i++) {
+            const dReal *p = dBodyGetPosition(bodies[i]);
+            const dReal *r = dBodyGetRotation(bodies[i]);
+            Matrix m = {
+                r[0], r[1], r[2], (float)p[0],
+                r[4], r[5], r[6], (float)p[1],
+                r[8], r[9], r[10], (float)p[2],
+                0, 0, 0, 1
+            };
+            cube_model.transform = m;
+            DrawModel(cube_model, (Vector3){0, 0, 0}, 1.0f, ORANGE);
+            DrawModelWires(cube_model, (Vector3){0, 0, 0}, 1.0f, BLACK);
+        }
 
+        SubmitDebugDraw(&debug_draw);
         EndMode3D();
 
         DrawFPS(10, 10);
@@ -147,11 +366,21 @@ int main() {
         char rot_text[64];
         sprintf(rot_text, "Rotation: Yaw: %.1f  Pitch: %.1f  Roll: %.1f", yaw, pitch, roll);
         DrawText(rot_text, 10, 90, 20, DARKGRAY);
+        DrawDebugDrawStats(&debug_draw, 10, 120);
 
         EndDrawing();
     }
 
+    UnloadDebugDraw(&debug_draw);
+    CloseSharedStateWriter(&shared_state);
     UnloadModel(cube_model);
+    if (terrain_geom) {
+        UnloadModel(terrain_model);
+        dGeomDestroy(terrain_geom);
+        DestroyTerrain(&terrain);
+    }
+    FreeTerrainMesh(&terrain_mesh);
+    free(bodies);
     dJointGroupDestroy(contact_group);
     dSpaceDestroy(space);
     dWorldDestroy(world);
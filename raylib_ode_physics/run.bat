@@ -1,3 +1,3 @@
 @echo off
 cd build/Debug
-cube_drop.exe
\ No newline at end of file
+cube_drop.exe %*
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "terrain_cache.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "perf_timer.h"
+
+// Matches GIT_TAG in CMakeLists.txt
+#define ODE_CACHE_VERSION 1606u
+
+// Cooked blob: per-triangle normals (3 floats each), then one use-flag byte per triangle
+static size_t normalsSize(int triangleCount) {
+    return sizeof(float) * 3 * (size_t)triangleCount;
+}
+
+static void cookedPath(const TerrainMesh *mesh, char *path, size_t size, uint64_t *hash) {
+    *hash = HashTerrainMesh(mesh, "ode", ODE_CACHE_VERSION);
+    GetCookedMeshPath(path, size, "ode", *hash);
+}
+
+static void computeFaceNormals(const TerrainMesh *mesh, float *normals) {
+    for (int t = 0; t < mesh->triangleCount; t++) {
+        const float *a = &mesh->vertices[3 * mesh->indices[3 * t + 0]];
+        const float *b = &mesh->vertices[3 * mesh->indices[3 * t + 1]];
+        const float *c = &mesh->vertices[3 * mesh->indices[3 * t + 2]];
+        float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float *n = &normals[3 * t];
+        n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+        float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length > 0.0f) {
+            n[0] /= length; n[1] /= length; n[2] /= length;
+        }
+    }
+}
+
+bool BuildTerrainData(const TerrainMesh *mesh, TerrainCollision *terrain) {
+    terrain->data = dGeomTriMeshDataCreate();
+    dGeomTriMeshDataBuildSingle(terrain->data,
+        mesh->vertices, 3 * sizeof(float), mesh->vertexCount,
+        mesh->indices, 3 * mesh->triangleCount, 3 * sizeof(uint32_t));
+    dGeomTriMeshDataPreprocess2(terrain->data, 1U << dTRIDATAPREPROCESS_BUILD_CONCAVE_EDGES, NULL);
+    terrain->fromCache = false;
+    return true;
+}
+
+bool RestoreTerrainData(TerrainCollision *terrain) {
+    CookedMesh *cooked = &terrain->cooked;
+    if (cooked->blobSize != normalsSize(cooked->triangleCount) + (size_t)cooked->triangleCount) return false;
+
+    float *normals = (float *)cooked->blob;
+    unsigned char *useFlags = (unsigned char *)cooked->blob + normalsSize(cooked->triangleCount);
+
+    terrain->data = dGeomTriMeshDataCreate();
+    dGeomTriMeshDataBuildSingle1(terrain->data,
+        cooked->vertices, 3 * sizeof(float), cooked->vertexCount,
+        cooked->indices, 3 * cooked->triangleCount, 3 * sizeof(uint32_t), normals);
+    dGeomTriMeshDataSet(terrain->data, dTRIMESHDATA_USE_FLAGS, useFlags);
+    terrain->fromCache = true;
+    return true;
+}
+
+bool LoadOrCookTerrain(const TerrainMesh *mesh, TerrainCollision *terrain) {
+    uint64_t hash;
+    char path[COOKED_MESH_PATH_MAX];
+    cookedPath(mesh, path, sizeof(path), &hash);
+
+    memset(terrain, 0, sizeof(*terrain));
+    if (LoadCookedMesh(&terrain->cooked, path, hash)) {
+        if (RestoreTerrainData(terrain)) return true;
+        UnloadCookedMesh(&terrain->cooked);
+    }
+
+    BuildTerrainData(mesh, terrain);
+
+    dsizeint flagsSize = 0;
+    const void *useFlags = dGeomTriMeshDataGet2(terrain->data, dTRIMESHDATA_USE_FLAGS, &flagsSize);
+    if (!useFlags || flagsSize != (dsizeint)mesh->triangleCount) {
+        printf("Terrain: no preprocessed flags to cook\n");
+        return true;
+    }
+
+    size_t blobSize = normalsSize(mesh->triangleCount) + (size_t)flagsSize;
+    unsigned char *blob = (unsigned char *)malloc(blobSize);
+    computeFaceNormals(mesh, (float *)blob);
+    memcpy(blob + normalsSize(mesh->triangleCount), useFlags, (size_t)flagsSize);
+    if (SaveCookedMesh(path, hash, mesh, blob, blobSize)) {
+        printf("Terrain cooked to %s (%zu bytes)\n", path, blobSize);
+    }
+    free(blob);
+    return true;
+}
+
+void DestroyTerrain(TerrainCollision *terrain) {
+    if (terrain->data) dGeomTriMeshDataDestroy(terrain->data);
+    UnloadCookedMesh(&terrain->cooked);
+    terrain->data = NULL;
+}
+
+void RunTerrainCookBenchmark(const TerrainMesh *mesh, int iterations) {
+    TerrainCollision terrain;
+    LoadOrCookTerrain(mesh, &terrain);
+    DestroyTerrain(&terrain);
+
+    uint64_t hash;
+    char path[COOKED_MESH_PATH_MAX];
+    cookedPath(mesh, path, sizeof(path), &hash);
+
+    double *buildSeconds = (double *)malloc(sizeof(double) * iterations);
+    double *cookedSeconds = (double *)malloc(sizeof(double) * iterations);
+    bool ok = true;
+    for (int i = 0; i < iterations && ok; i++) {
+        memset(&terrain, 0, sizeof(terrain));
+        double start = PerfNowSeconds();
+        BuildTerrainData(mesh, &terrain);
+        buildSeconds[i] = PerfNowSeconds() - start;
+        DestroyTerrain(&terrain);
+
+        memset(&terrain, 0, sizeof(terrain));
+        start = PerfNowSeconds();
+        ok = LoadCookedMesh(&terrain.cooked, path, hash) && RestoreTerrainData(&terrain);
+        cookedSeconds[i] = PerfNowSeconds() - start;
+        DestroyTerrain(&terrain);
+    }
+
+    if (ok) {
+        ReportCookBenchmark("ODE dGeomTriMeshData", mesh, buildSeconds, cookedSeconds, iterations);
+    } else {
+        printf("Terrain benchmark aborted: cannot load %s\n", path);
+    }
+    free(buildSeconds);
+    free(cookedSeconds);
+}
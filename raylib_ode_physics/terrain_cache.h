@@ -0,0 +1,32 @@
+#ifndef TERRAIN_CACHE_H
+#define TERRAIN_CACHE_H
+
+// Static terrain dGeomTriMeshData: built and preprocessed from scratch, or fed
+// from the cooked cache (face normals + preprocessed edge flags) mapped from disk.
+// ODE has no way to serialize its OPCODE tree, that part is still built on load.
+
+#include <stdbool.h>
+#include "ode/ode.h"
+#include "terrain_mesh.h"
+
+typedef struct TerrainCollision {
+    dTriMeshDataID data;
+    CookedMesh cooked;      // Triangles, normals and flags point into this mapping when fromCache
+    bool fromCache;
+} TerrainCollision;
+
+// Builds the trimesh data and runs the concave edge preprocessing (mesh must outlive the data)
+bool BuildTerrainData(const TerrainMesh *mesh, TerrainCollision *terrain);
+
+// Builds the trimesh data from the mapped cooked file, skipping the preprocessing
+bool RestoreTerrainData(TerrainCollision *terrain);
+
+// Uses the cooked file for this mesh when present, otherwise builds and writes it
+bool LoadOrCookTerrain(const TerrainMesh *mesh, TerrainCollision *terrain);
+
+void DestroyTerrain(TerrainCollision *terrain);
+
+// Times both startup paths and prints the comparison
+void RunTerrainCookBenchmark(const TerrainMesh *mesh, int iterations);
+
+#endif // TERRAIN_CACHE_H
@@ -1,3 +1,3 @@
 @echo off
 cd build/Debug
-drop_cube.exe
\ No newline at end of file
+drop_cube.exe %*
\ No newline at end of file
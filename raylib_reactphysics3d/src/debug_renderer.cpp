@@ -0,0 +1,104 @@
+#include "debug_renderer.h"
+
+#include <cmath>
+
+using namespace reactphysics3d;
+
+namespace {
+
+uint32_t toColor(uint32 rgb) {
+    return DEBUG_DRAW_RGBA((rgb >> 16) & 0xff, (rgb >> 8) & 0xff, rgb & 0xff, 255);
+}
+
+void toFloat3(const Vector3& v, float out[3]) {
+    out[0] = v.x;
+    out[1] = v.y;
+    out[2] = v.z;
+}
+
+// Lines do not carry their DebugItem, so every line item gets its own color
+// in ConfigureDebugRenderer (0xRRGGBB) and the color tells them apart
+constexpr uint32 shapeColor = 0x00e430;
+constexpr uint32 aabbColor = 0xff00ff;
+constexpr uint32 broadphaseColor = 0xffff00;
+constexpr uint32 contactNormalColor = 0xe62937;     // Same red as the ODE contacts
+
+// 0 for lines of items not collected here
+unsigned int lineCategory(uint32 color) {
+    switch (color) {
+        case aabbColor: return DEBUG_DRAW_AABBS;
+        case broadphaseColor: return DEBUG_DRAW_BROADPHASE;
+        case contactNormalColor: return DEBUG_DRAW_CONTACTS;
+        default: return 0;
+    }
+}
+
+} // namespace
+
+void ConfigureDebugRenderer(PhysicsWorld* world, const DebugDraw& draw) {
+    using Item = DebugRenderer::DebugItem;
+    const unsigned int items = DEBUG_DRAW_SHAPES | DEBUG_DRAW_CONTACTS | DEBUG_DRAW_AABBS | DEBUG_DRAW_BROADPHASE;
+    world->setIsDebugRenderingEnabled(IsDebugDrawEnabled(&draw, items));
+
+    DebugRenderer& renderer = world->getDebugRenderer();
+    renderer.setColor(Item::COLLISION_SHAPE, shapeColor);
+    renderer.setColor(Item::COLLIDER_AABB, aabbColor);
+    renderer.setColor(Item::COLLIDER_BROADPHASE_AABB, broadphaseColor);
+    renderer.setColor(Item::CONTACT_NORMAL, contactNormalColor);
+    renderer.setIsDebugItemDisplayed(Item::COLLISION_SHAPE, IsDebugDrawEnabled(&draw, DEBUG_DRAW_SHAPES));
+    renderer.setIsDebugItemDisplayed(Item::COLLIDER_AABB, IsDebugDrawEnabled(&draw, DEBUG_DRAW_AABBS));
+    renderer.setIsDebugItemDisplayed(Item::COLLIDER_BROADPHASE_AABB, IsDebugDrawEnabled(&draw, DEBUG_DRAW_BROADPHASE));
+    // Contact points are tessellated spheres, far too many triangles for big scenes: normals only
+    renderer.setIsDebugItemDisplayed(Item::CONTACT_POINT, false);
+    renderer.setIsDebugItemDisplayed(Item::CONTACT_NORMAL, IsDebugDrawEnabled(&draw, DEBUG_DRAW_CONTACTS));
+    renderer.setIsDebugItemDisplayed(Item::COLLISION_SHAPE_NORMAL, false);
+}
+
+void CollectDebugPrimitives(PhysicsWorld* world, DebugDraw& draw) {
+    if (world->getIsDebugRenderingEnabled()) {
+        const DebugRenderer& renderer = world->getDebugRenderer();
+
+        const uint32 lineCount = renderer.getNbLines();
+        const DebugRenderer::DebugLine* lines = lineCount > 0 ? renderer.getLinesArray() : nullptr;
+        for (uint32 i = 0; i < lineCount; i++) {
+            unsigned int category = lineCategory(lines[i].color1);
+            if (category == 0) continue;
+            float a[3], b[3];
+            toFloat3(lines[i].point1, a);
+            toFloat3(lines[i].point2, b);
+            if (category == DEBUG_DRAW_CONTACTS) {
+                Vector3 normal = lines[i].point2 - lines[i].point1;
+                float length = normal.length();
+                float n[3] = { 0.0f, 1.0f, 0.0f };
+                if (length > 0.0f) toFloat3(normal / length, n);
+                DebugDrawContact(&draw, a, n, toColor(lines[i].color1));
+            } else {
+                DebugDrawLine(&draw, category, a, b, toColor(lines[i].color1));
+            }
+        }
+
+        const uint32 triangleCount = renderer.getNbTriangles();
+        const DebugRenderer::DebugTriangle* triangles = triangleCount > 0 ? renderer.getTrianglesArray() : nullptr;
+        for (uint32 i = 0; i < triangleCount; i++) {
+            float v1[3], v2[3], v3[3];
+            toFloat3(triangles[i].point1, v1);
+            toFloat3(triangles[i].point2, v2);
+            toFloat3(triangles[i].point3, v3);
+            uint32_t color = toColor(triangles[i].color1);
+            DebugDrawLine(&draw, DEBUG_DRAW_SHAPES, v1, v2, color);
+            DebugDrawLine(&draw, DEBUG_DRAW_SHAPES, v2, v3, color);
+            DebugDrawLine(&draw, DEBUG_DRAW_SHAPES, v3, v1, color);
+        }
+    }
+
+    if (IsDebugDrawEnabled(&draw, DEBUG_DRAW_CONSTRAINTS)) {
+        const uint32_t color = DEBUG_DRAW_RGBA(0, 0, 255, 255);
+        for (uint32 i = 0; i < world->getNbJoints(); i++) {
+            const Joint* joint = world->getJoint(i);
+            float a[3], b[3];
+            toFloat3(joint->getBody1()->getTransform().getPosition(), a);
+            toFloat3(joint->getBody2()->getTransform().getPosition(), b);
+            DebugDrawLine(&draw, DEBUG_DRAW_CONSTRAINTS, a, b, color);
+        }
+    }
+}
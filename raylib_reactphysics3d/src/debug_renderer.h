@@ -0,0 +1,17 @@
+#pragma once
+
+// Copies the ReactPhysics3D DebugRenderer output into the shared batched
+// DebugDraw buffers. rp3d builds its primitives at the end of
+// PhysicsWorld::update, so the displayed items are synced with the toggles
+// before the update and the arrays are collected after it.
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "debug_draw.h"
+
+// Enables debug rendering and the DebugItems matching the enabled categories
+void ConfigureDebugRenderer(reactphysics3d::PhysicsWorld* world, const DebugDraw& draw);
+
+// Shape triangles become wireframe lines, contact normals become contact
+// markers, AABB lines are kept as they are. Joints are drawn here, rp3d has no item for them.
+void CollectDebugPrimitives(reactphysics3d::PhysicsWorld* world, DebugDraw& draw);
@@ -4,6 +4,7 @@
 #include <iomanip>
 #include <cmath>
 #include <random>
+#include <vector>
 
 #define WIN32_LEAN_AND_MEAN
 #define NOCOLOR
@@ -12,9 +13,21 @@
 
 #include <reactphysics3d/reactphysics3d.h>
 
+#include "body_state.h"
+#include "debug_draw.h"
+#include "debug_renderer.h"
+#include "demo_options.h"
+#include "net_server.h"
+#include "perf_timer.h"
+#include "shared_state.h"
+#include "step_profiler.h"
+#include "terrain_mesh.h"
+#include "terrain_cache.h"
+
 namespace rl {
     #include "raylib.h"
     #include "raymath.h"
+    #include "terrain_model.h"
 }
 
 using namespace reactphysics3d;
@@ -43,32 +56,75 @@ Vector3 getEulerAngles(const Quaternion& q) {
     return Vector3(pitch, yaw, roll);
 }
 
-// Function to reset cube position and apply random rotation
-void resetCube(RigidBody* cubeBody, Vector3 initialPos) {
-    Transform resetTransform(initialPos, Quaternion::identity());
-    cubeBody->setTransform(resetTransform);
-
+// Function to reset cube positions to their spawn points, optionally applying a random rotation
+void resetCubes(const std::vector<RigidBody*>& cubeBodies, bool randomize) {
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_real_distribution<float> dist(0.0f, 2.0f * PI);
-    float yaw = dist(gen);
-    float pitch = dist(gen);
-    float roll = dist(gen);
-    Quaternion randomRot = Quaternion::fromEulerAngles(pitch, yaw, roll);
-    Transform currentTransform = cubeBody->getTransform();
-    currentTransform.setOrientation(randomRot);
-    cubeBody->setTransform(currentTransform);
-
-    cubeBody->setLinearVelocity(Vector3(0.0f, 0.0f, 0.0f));
-    cubeBody->setAngularVelocity(Vector3(0.0f, 0.0f, 0.0f));
+
+    for (size_t i = 0; i < cubeBodies.size(); i++) {
+        float spawn[3];
+        GetSpawnPosition((int)i, 5.0f, spawn);
+        Quaternion orientation = Quaternion::identity();
+        if (randomize) {
+            float yaw = dist(gen);
+            float pitch = dist(gen);
+            float roll = dist(gen);
+            orientation = Quaternion::fromEulerAngles(pitch, yaw, roll);
+        }
+
+        RigidBody* cubeBody = cubeBodies[i];
+        cubeBody->setTransform(Transform(Vector3(spawn[0], spawn[1], spawn[2]), orientation));
+        cubeBody->setLinearVelocity(Vector3(0.0f, 0.0f, 0.0f));
+        cubeBody->setAngularVelocity(Vector3(0.0f, 0.0f, 0.0f));
+    }
 }
 
-int main() {
-    // Initialize Raylib window
-    const int screenWidth = 800;
-    const int screenHeight = 600;
-    rl::InitWindow(screenWidth, screenHeight, "Cube Drop Test");
-    rl::SetTargetFPS(60);
+// State handed to the simulation server (--server) and shared state (--shm) callbacks
+struct ServerContext {
+    PhysicsWorld* world;
+    std::vector<RigidBody*>* cubeBodies;
+    SharedStateWriter* sharedState;
+};
+
+// Transforms of the first count cubes
+void gatherCubeStates(void* user, BodyState* states, int count) {
+    const std::vector<RigidBody*>& cubeBodies = *static_cast<ServerContext*>(user)->cubeBodies;
+    for (int i = 0; i < count; i++) {
+        const Transform& transform = cubeBodies[i]->getTransform();
+        const Vector3& position = transform.getPosition();
+        const Quaternion& orientation = transform.getOrientation();
+        const BoxShape* shape = static_cast<const BoxShape*>(cubeBodies[i]->getCollider(0)->getCollisionShape());
+        Vector3 halfExtents = shape->getHalfExtents();
+        states[i].position[0] = position.x;
+        states[i].position[1] = position.y;
+        states[i].position[2] = position.z;
+        states[i].rotation[0] = orientation.x;
+        states[i].rotation[1] = orientation.y;
+        states[i].rotation[2] = orientation.z;
+        states[i].rotation[3] = orientation.w;
+        states[i].halfExtents[0] = halfExtents.x;
+        states[i].halfExtents[1] = halfExtents.y;
+        states[i].halfExtents[2] = halfExtents.z;
+    }
+}
+
+int main(int argc, char** argv) {
+    DemoOptions options;
+    ParseDemoOptions(&options, argc, argv);
+
+    // Static terrain, generated here; in a real level this is the loaded asset
+    TerrainMesh terrainMesh = { 0 };
+    if (options.terrainCells > 0 && !GenTerrainMesh(&terrainMesh, options.terrainCells, 1.0f, 2.0f)) {
+        return 1;
+    }
+
+    if (options.benchCookIterations > 0) {
+        PhysicsCommon benchCommon;
+        RunTerrainCookBenchmark(benchCommon, terrainMesh, options.benchCookIterations);
+        FreeTerrainMesh(&terrainMesh);
+        return 0;
+    }
 
     // Initialize ReactPhysics3D
     PhysicsCommon physicsCommon;
@@ -83,6 +139,23 @@ int main() {
     BoxShape* groundShape = physicsCommon.createBoxShape(Vector3(10.0f, 0.5f, 10.0f));
     groundBody->addCollider(groundShape, Transform::identity());
 
+    // Create terrain from the cooked cache (built and cooked on first run), resting on the ground box
+    Vector3 terrainPos(0.0f, -1.5f, 0.0f);
+    TerrainCollision terrain;
+    RigidBody* terrainBody = nullptr;
+    rl::Model terrainModel{};
+    if (terrainMesh.triangleCount > 0) {
+        double start = PerfNowSeconds();
+        if (LoadOrCookTerrain(physicsCommon, terrainMesh, terrain)) {
+            terrainBody = world->createRigidBody(Transform(terrainPos, Quaternion::identity()));
+            terrainBody->setType(BodyType::STATIC);
+            terrainBody->addCollider(terrain.shape, Transform::identity());
+            std::cout << "Terrain created (" << terrainMesh.triangleCount << " triangles, "
+                      << (terrain.fromCache ? "cooked" : "built") << ") in "
+                      << (PerfNowSeconds() - start) * 1000.0 << " ms\n";
+        }
+    }
+
     // Create cube (dynamic body)
     Vector3 cubeInitialPos(0.0f, 5.0f, 0.0f);
     Transform cubeTransform(cubeInitialPos, Quaternion::identity());
@@ -92,90 +165,175 @@ int main() {
     cubeBody->addCollider(cubeShape, Transform::identity());
     cubeBody->setMass(1.0f);
 
-    // Generate cube mesh
-    rl::Mesh cubeMesh = rl::GenMeshCube(1.0f, 1.0f, 1.0f);
-    rl::Model cubeModel = rl::LoadModelFromMesh(cubeMesh);
-
-    // Camera setup for Raylib
-    rl::Camera3D camera{};
-    camera.position = rl::Vector3{ 10.0f, 10.0f, 10.0f };
-    camera.target = rl::Vector3{ 0.0f, 0.0f, 0.0f };
-    camera.up = rl::Vector3{ 0.0f, 1.0f, 0.0f };
-    camera.fovy = 45.0f;
-    camera.projection = rl::CAMERA_PERSPECTIVE;
-
-    while (!rl::WindowShouldClose()) {
-        // Reset cube on R key press
-        if (rl::IsKeyPressed(rl::KEY_R)) {
-            resetCube(cubeBody, cubeInitialPos);
+    // Extra cubes for --bodies, stacked above the demo cube and sharing its shape
+    std::vector<RigidBody*> cubeBodies = { cubeBody };
+    for (int i = 1; i < options.bodyCount; i++) {
+        float spawn[3];
+        GetSpawnPosition(i, 5.0f, spawn);
+        RigidBody* body = world->createRigidBody(Transform(Vector3(spawn[0], spawn[1], spawn[2]), Quaternion::identity()));
+        body->setType(BodyType::DYNAMIC);
+        body->addCollider(cubeShape, Transform::identity());
+        body->setMass(1.0f);
+        cubeBodies.push_back(body);
+    }
+
+    // Out-of-process viewers (--shm), published after every step
+    SharedStateWriter sharedState = {};
+    if (options.sharedStateName && options.profileSteps == 0) {
+        OpenSharedStateWriter(&sharedState, options.sharedStateName, "ReactPhysics3D", (int)cubeBodies.size());
+    }
+    ServerContext context = { world, &cubeBodies, &sharedState };
+
+    // Headless: fixed number of steps with the per-phase breakdown
+    // or step at the server tick rate and stream state to viewers
+    int result = 0;
+    if (options.profileSteps > 0) {
+        RunStepProfile(world, options.profileSteps);
+    } else if (options.serverPort > 0) {
+        NetServerConfig config = { (uint16_t)options.serverPort, options.tickRate,
+                                   (uint32_t)options.serverBudget, (int)cubeBodies.size() };
+        NetServerCallbacks callbacks;
+        callbacks.user = &context;
+        callbacks.step = [](void* user, float dt) {
+            ServerContext* ctx = static_cast<ServerContext*>(user);
+            ctx->world->update(dt);
+            PublishSharedState(ctx->sharedState, gatherCubeStates, ctx, (int)ctx->cubeBodies->size());
+        };
+        callbacks.gather = gatherCubeStates;
+        callbacks.command = [](void* user, int command) {
+            resetCubes(*static_cast<ServerContext*>(user)->cubeBodies, command == NET_COMMAND_RANDOMIZE);
+        };
+        result = RunNetServer(&config, &callbacks);
+    } else {
+        // Initialize Raylib window
+        const int screenWidth = 800;
+        const int screenHeight = 600;
+        rl::InitWindow(screenWidth, screenHeight, "Cube Drop Test");
+        rl::SetTargetFPS(60);
+
+        if (terrainBody) {
+            terrainModel = rl::LoadTerrainModel(terrainMesh.vertices, terrainMesh.indices, terrainMesh.triangleCount);
         }
 
-        // Update physics
-        world->update(1.0f / 60.0f);
-
-        // Get cube transform from physics engine
-        Transform cubeTransformUpdated = cubeBody->getTransform();
-        Vector3 cubePos = cubeTransformUpdated.getPosition();
-        Quaternion cubeRot = cubeTransformUpdated.getOrientation();
-
-        // Convert quaternion to Euler angles for display (in degrees)
-        Vector3 eulerAngles = getEulerAngles(cubeRot) * (180.0f / PI);
-
-        // Convert ReactPhysics3D transform to Raylib matrix
-        rl::Matrix transform = rl::MatrixIdentity();
-        transform = rl::MatrixMultiply(transform, rl::QuaternionToMatrix({ cubeRot.x, cubeRot.y, cubeRot.z, cubeRot.w }));
-        transform = rl::MatrixMultiply(transform, rl::MatrixTranslate(cubePos.x, cubePos.y, cubePos.z));
-        cubeModel.transform = transform;
-
-        // Begin drawing
-        rl::BeginDrawing();
-        rl::ClearBackground(rl::RAYWHITE);
-
-        rl::BeginMode3D(camera);
-        {
-            rl::DrawCubeV(rl::Vector3{ groundPos.x, groundPos.y, groundPos.z },
-                          rl::Vector3{ 20.0f, 1.0f, 20.0f }, rl::GRAY);
-            rl::DrawModel(cubeModel, rl::Vector3{ 0.0f, 0.0f, 0.0f }, 1.0f, rl::RED);
-            rl::DrawGrid(10, 1.0f);
+        // Engine debug drawing, batched (F1..F5 toggle categories)
+        DebugDraw debugDraw;
+        InitDebugDraw(&debugDraw, options.debugDrawMax, (unsigned int)options.debugDrawCategories);
+
+        // Generate cube mesh
+        rl::Mesh cubeMesh = rl::GenMeshCube(1.0f, 1.0f, 1.0f);
+        rl::Model cubeModel = rl::LoadModelFromMesh(cubeMesh);
+
+        // Camera setup for Raylib
+        rl::Camera3D camera{};
+        camera.position = rl::Vector3{ 10.0f, 10.0f, 10.0f };
+        camera.target = rl::Vector3{ 0.0f, 0.0f, 0.0f };
+        camera.up = rl::Vector3{ 0.0f, 1.0f, 0.0f };
+        camera.fovy = 45.0f;
+        camera.projection = rl::CAMERA_PERSPECTIVE;
+
+        while (!rl::WindowShouldClose()) {
+            // Reset cube on R key press
+            if (rl::IsKeyPressed(rl::KEY_R)) {
+                resetCubes(cubeBodies, true);
+            }
+
+            // Update physics
+            UpdateDebugDrawToggles(&debugDraw);
+            ConfigureDebugRenderer(world, debugDraw);
+            world->update(1.0f / 60.0f);
+            PublishSharedState(&sharedState, gatherCubeStates, &context, (int)cubeBodies.size());
+            BeginDebugDraw(&debugDraw);
+            CollectDebugPrimitives(world, debugDraw);
+
+            // Get cube transform from physics engine
+            Transform cubeTransformUpdated = cubeBody->getTransform();
+            Vector3 cubePos = cubeTransformUpdated.getPosition();
+            Quaternion cubeRot = cubeTransformUpdated.getOrientation();
+
+            // Convert quaternion to Euler angles for display (in degrees)
+            Vector3 eulerAngles = getEulerAngles(cubeRot) * (180.0f / PI);
+
+            // Convert ReactPhysics3D transform to Raylib matrix
+            rl::Matrix transform = rl::MatrixIdentity();
+            transform = rl::MatrixMultiply(transform, rl::QuaternionToMatrix({ cubeRot.x, cubeRot.y, cubeRot.z, cubeRot.w }));
+            transform = rl::MatrixMultiply(transform, rl::MatrixTranslate(cubePos.x, cubePos.y, cubePos.z));
+            cubeModel.transform = transform;
+
+            // Begin drawing
+            rl::BeginDrawing();
+            rl::ClearBackground(rl::RAYWHITE);
+
+            rl::BeginMode3D(camera);
+            {
+                rl::DrawCubeV(rl::Vector3{ groundPos.x, groundPos.y, groundPos.z },
+                              rl::Vector3{ 20.0f, 1.0f, 20.0f }, rl::GRAY);
+                if (terrainBody) {
+                    rl::DrawModel(terrainModel, rl::Vector3{ terrainPos.x, terrainPos.y, terrainPos.z }, 1.0f, rl::WHITE);
+                }
+                rl::DrawModel(cubeModel, rl::Vector3{ 0.0f, 0.0f, 0.0f }, 1.0f, rl::RED);
+                // With shapes on the batched debug wireframes replace the per-body draw calls
+                for (size_t i = 1; i < cubeBodies.size() && !IsDebugDrawEnabled(&debugDraw, DEBUG_DRAW_SHAPES); i++) {
+                    const Transform& extraTransform = cubeBodies[i]->getTransform();
+                    const Vector3& extraPos = extraTransform.getPosition();
+                    const Quaternion& extraRot = extraTransform.getOrientation();
+                    cubeModel.transform = rl::MatrixMultiply(rl::QuaternionToMatrix({ extraRot.x, extraRot.y, extraRot.z, extraRot.w }),
+                                                             rl::MatrixTranslate(extraPos.x, extraPos.y, extraPos.z));
+                    rl::DrawModel(cubeModel, rl::Vector3{ 0.0f, 0.0f, 0.0f }, 1.0f, rl::ORANGE);
+                }
+                rl::DrawGrid(10, 1.0f);
+                SubmitDebugDraw(&debugDraw);
+            }
+            rl::EndMode3D();
+
+            // Draw text information
+            int textY = 10;
+            const int textSpacing = 20;
+
+            // Position
+            std::ostringstream posStream;
+            posStream << std::fixed << std::setprecision(2)
+                      << "Position: (" << cubePos.x << ", " << cubePos.y << ", " << cubePos.z << ")";
+            rl::DrawText(posStream.str().c_str(), 10, textY, 20, rl::BLACK);
+            textY += textSpacing;
+
+            // Rotation (Euler angles in degrees)
+            std::ostringstream rotStream;
+            rotStream << std::fixed << std::setprecision(2)
+                      << "Rotation: (Pitch: " << eulerAngles.x << ", Yaw: " << eulerAngles.y << ", Roll: " << eulerAngles.z << ")";
+            rl::DrawText(rotStream.str().c_str(), 10, textY, 20, rl::BLACK);
+            textY += textSpacing;
+
+            // Input instructions
+            rl::DrawText("Press R to reset position and randomize rotation", 10, textY, 20, rl::DARKGRAY);
+            textY += textSpacing;
+
+            DrawDebugDrawStats(&debugDraw, 10, textY);
+
+            // Draw FPS
+            rl::DrawFPS(screenWidth - 100, 10);
+
+            rl::EndDrawing();
         }
-        rl::EndMode3D();
-
-        // Draw text information
-        int textY = 10;
-        const int textSpacing = 20;
-
-        // Position
-        std::ostringstream posStream;
-        posStream << std::fixed << std::setprecision(2)
-                  << "Position: (" << cubePos.x << ", " << cubePos.y << ", " << cubePos.z << ")";
-        rl::DrawText(posStream.str().c_str(), 10, textY, 20, rl::BLACK);
-        textY += textSpacing;
-
-        // Rotation (Euler angles in degrees)
-        std::ostringstream rotStream;
-        rotStream << std::fixed << std::setprecision(2)
-                  << "Rotation: (Pitch: " << eulerAngles.x << ", Yaw: " << eulerAngles.y << ", Roll: " << eulerAngles.z << ")";
-        rl::DrawText(rotStream.str().c_str(), 10, textY, 20, rl::BLACK);
-        textY += textSpacing;
-
-        // Input instructions
-        rl::DrawText("Press R to reset position and randomize rotation", 10, textY, 20, rl::DARKGRAY);
-        textY += textSpacing;
-
-        // Draw FPS
-        rl::DrawFPS(screenWidth - 100, 10);
-
-        rl::EndDrawing();
+
+        // Cleanup Raylib
+        UnloadDebugDraw(&debugDraw);
+        if (terrainBody) rl::UnloadModel(terrainModel);
+        rl::UnloadModel(cubeModel);
+        rl::CloseWindow();
     }
 
     // Cleanup physics
-    world->destroyRigidBody(cubeBody);
+    CloseSharedStateWriter(&sharedState);
+    for (RigidBody* body : cubeBodies) {
+        world->destroyRigidBody(body);
+    }
     world->destroyRigidBody(groundBody);
+    if (terrainBody) {
+        world->destroyRigidBody(terrainBody);
+    }
+    DestroyTerrain(physicsCommon, terrain);
+    FreeTerrainMesh(&terrainMesh);
     physicsCommon.destroyPhysicsWorld(world);
 
-    // Cleanup Raylib
-    rl::UnloadModel(cubeModel);
-    rl::CloseWindow();
-
-    return 0;
+    return result;
 }
\ No newline at end of file
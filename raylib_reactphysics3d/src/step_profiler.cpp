@@ -0,0 +1,83 @@
+#include "step_profiler.h"
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+#include <reactphysics3d/utils/Profiler.h>
+#endif
+
+#include "perf_timer.h"
+#include "step_profile.h"
+
+using namespace reactphysics3d;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+namespace {
+
+// RP3D_PROFILE block names of PhysicsWorld::update. computeCollisionDetection and
+// solveContactsAndConstraints span several phases, their children are used.
+const StepPhaseRule rp3dRules[] = {
+    { "solveContactsAndConstraints", STEP_PHASE_NONE },
+    { "BroadPhase", STEP_PHASE_BROADPHASE },
+    { "MiddlePhase", STEP_PHASE_NARROWPHASE },
+    { "NarrowPhase", STEP_PHASE_NARROWPHASE },
+    { "createIslands", STEP_PHASE_CONSTRAINT_SETUP },
+    { "::init", STEP_PHASE_CONSTRAINT_SETUP },          // ContactSolverSystem::init, joint initBeforeSolve
+    { "::solve", STEP_PHASE_SOLVE },                    // Contact and joint iterations, position correction
+    { "storeImpulses", STEP_PHASE_SOLVE },
+    { "integrate", STEP_PHASE_INTEGRATE },
+};
+
+// Leaves the iterator on child index of the current parent, enterParent rewinds it
+void seekChild(ProfileNodeIterator* it, int index) {
+    it->first();
+    for (int i = 0; i < index && !it->isEnd(); i++) it->next();
+}
+
+void collectBlocks(ProfileNodeIterator* it, StepProfile& profile) {
+    for (int index = 0;; index++) {
+        seekChild(it, index);
+        if (it->isEnd()) break;
+
+        StepPhase phase = ClassifyStepScope(rp3dRules, (int)(sizeof(rp3dRules) / sizeof(rp3dRules[0])),
+                                            it->getCurrentName());
+        if (phase != STEP_PHASE_NONE) {
+            AddStepPhaseTime(&profile, phase, (double)it->getCurrentTotalTime() / 1000.0); // ms
+            continue;
+        }
+        it->enterChild(index);
+        collectBlocks(it, profile);
+        it->enterParent();
+    }
+}
+
+} // namespace
+
+#endif // IS_RP3D_PROFILING_ENABLED
+
+void RunStepProfile(PhysicsWorld* world, int steps) {
+    StepProfile profile;
+#ifdef IS_RP3D_PROFILING_ENABLED
+    InitStepProfile(&profile, "ReactPhysics3D", "rp3d Profiler blocks (RP3D_PROFILE)", steps);
+    Profiler* profiler = world->getProfiler();
+    profiler->reset();
+#else
+    InitStepProfile(&profile, "ReactPhysics3D", "nothing: configure with -DPHYSICS_PROFILE=ON for the phase times", steps);
+#endif
+
+    for (int i = 0; i < steps; i++) {
+        double start = PerfNowSeconds();
+        world->update(1.0f / 60.0f);
+        double wall = PerfNowSeconds() - start;
+#ifdef IS_RP3D_PROFILING_ENABLED
+        ProfileNodeIterator* it = profiler->getIterator();
+        collectBlocks(it, profile);
+        Profiler::destroyIterator(it);
+        profiler->reset();
+#endif
+        RecordProfiledStep(&profile, wall);
+    }
+
+    PrintStepProfile(&profile);
+    ExportStepProfile(&profile, "step_profile_rp3d.csv");
+    UnloadStepProfile(&profile);
+}
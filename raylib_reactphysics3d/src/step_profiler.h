@@ -0,0 +1,11 @@
+#pragma once
+
+// --profile for ReactPhysics3D. PHYSICS_PROFILE builds rp3d with
+// RP3D_PROFILING_ENABLED; after each update the world's Profiler tree is
+// walked, the outermost block matching a phase rule takes its subtree's
+// time, and the profiler is reset for the next step.
+
+#include <reactphysics3d/reactphysics3d.h>
+
+// Steps the world, prints the phase table and writes step_profile_rp3d.csv
+void RunStepProfile(reactphysics3d::PhysicsWorld* world, int steps);
@@ -0,0 +1,157 @@
+#include "terrain_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "perf_timer.h"
+
+using namespace reactphysics3d;
+
+namespace {
+
+// Matches GIT_TAG in CMakeLists.txt
+constexpr uint32_t cReactPhysics3DVersion = 10002;
+// Bumped when the cached normals change, files with the old ones are never loaded
+constexpr uint32_t cNormalsRevision = 2;
+
+void cookedPath(const TerrainMesh& mesh, char* path, size_t size, uint64_t& hash) {
+    hash = HashTerrainMesh(&mesh, "rp3d", cReactPhysics3DVersion * 16 + cNormalsRevision);
+    GetCookedMeshPath(path, size, "rp3d", hash);
+}
+
+// Vertex normals as TriangleVertexArray::computeVerticesNormals builds them:
+// each corner adds its edge cross product weighted by asin of the clamped
+// corner sine, so cached and uncached runs collide against the same normals
+std::vector<float> computeVertexNormals(const TerrainMesh& mesh) {
+    std::vector<float> normals(3 * (size_t)mesh.vertexCount, 0.0f);
+    for (int t = 0; t < mesh.triangleCount; t++) {
+        const uint32_t* tri = &mesh.indices[3 * t];
+        Vector3 p[3];
+        for (int k = 0; k < 3; k++) {
+            const float* v = &mesh.vertices[3 * tri[k]];
+            p[k] = Vector3(v[0], v[1], v[2]);
+        }
+
+        for (int k = 0; k < 3; k++) {
+            Vector3 a = p[(k + 1) % 3] - p[k];
+            Vector3 b = p[(k + 2) % 3] - p[k];
+            Vector3 cross = a.cross(b);
+            decimal sinA = cross.length() / (a.length() * b.length());
+            sinA = std::min(std::max(sinA, decimal(0.0)), decimal(0.99999));
+            Vector3 component = std::asin(sinA) * cross;
+            float* n = &normals[3 * tri[k]];
+            n[0] += component.x;
+            n[1] += component.y;
+            n[2] += component.z;
+        }
+    }
+    for (int i = 0; i < mesh.vertexCount; i++) {
+        float* n = &normals[3 * i];
+        float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length > 0.0f) {
+            n[0] /= length; n[1] /= length; n[2] /= length;
+        }
+    }
+    return normals;
+}
+
+bool createShape(PhysicsCommon& physicsCommon, const TriangleVertexArray& vertexArray, TerrainCollision& terrain) {
+    std::vector<Message> messages;
+    terrain.triangleMesh = physicsCommon.createTriangleMesh(vertexArray, messages);
+    for (const Message& message : messages) {
+        std::cerr << "Terrain TriangleMesh: " << message.text << "\n";
+    }
+    if (terrain.triangleMesh == nullptr) return false;
+    terrain.shape = physicsCommon.createConcaveMeshShape(terrain.triangleMesh);
+    return true;
+}
+
+} // namespace
+
+bool BuildTerrainShape(PhysicsCommon& physicsCommon, const TerrainMesh& mesh, TerrainCollision& terrain) {
+    TriangleVertexArray vertexArray(
+        mesh.vertexCount, mesh.vertices, 3 * sizeof(float),
+        mesh.triangleCount, mesh.indices, 3 * sizeof(uint32_t),
+        TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+        TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+    terrain.fromCache = false;
+    return createShape(physicsCommon, vertexArray, terrain);
+}
+
+bool RestoreTerrainShape(PhysicsCommon& physicsCommon, const CookedMesh& cooked, TerrainCollision& terrain) {
+    if (cooked.blobSize != sizeof(float) * 3 * (size_t)cooked.vertexCount) return false;
+
+    TriangleVertexArray vertexArray(
+        cooked.vertexCount, cooked.vertices, 3 * sizeof(float),
+        cooked.blob, 3 * sizeof(float),
+        cooked.triangleCount, cooked.indices, 3 * sizeof(uint32_t),
+        TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+        TriangleVertexArray::NormalDataType::NORMAL_FLOAT_TYPE,
+        TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+    terrain.fromCache = true;
+    return createShape(physicsCommon, vertexArray, terrain);
+}
+
+bool LoadOrCookTerrain(PhysicsCommon& physicsCommon, const TerrainMesh& mesh, TerrainCollision& terrain) {
+    uint64_t hash;
+    char path[COOKED_MESH_PATH_MAX];
+    cookedPath(mesh, path, sizeof(path), hash);
+
+    // createTriangleMesh copies the arrays, so the mapping can go right away
+    CookedMesh cooked;
+    if (LoadCookedMesh(&cooked, path, hash)) {
+        bool restored = RestoreTerrainShape(physicsCommon, cooked, terrain);
+        UnloadCookedMesh(&cooked);
+        if (restored) return true;
+        DestroyTerrain(physicsCommon, terrain);
+    }
+
+    std::vector<float> normals = computeVertexNormals(mesh);
+    if (SaveCookedMesh(path, hash, &mesh, normals.data(), normals.size() * sizeof(float))) {
+        std::cout << "Terrain cooked to " << path << "\n";
+    }
+    return BuildTerrainShape(physicsCommon, mesh, terrain);
+}
+
+void DestroyTerrain(PhysicsCommon& physicsCommon, TerrainCollision& terrain) {
+    if (terrain.shape) physicsCommon.destroyConcaveMeshShape(terrain.shape);
+    if (terrain.triangleMesh) physicsCommon.destroyTriangleMesh(terrain.triangleMesh);
+    terrain.shape = nullptr;
+    terrain.triangleMesh = nullptr;
+}
+
+void RunTerrainCookBenchmark(PhysicsCommon& physicsCommon, const TerrainMesh& mesh, int iterations) {
+    TerrainCollision warmup;
+    LoadOrCookTerrain(physicsCommon, mesh, warmup);
+    DestroyTerrain(physicsCommon, warmup);
+
+    uint64_t hash;
+    char path[COOKED_MESH_PATH_MAX];
+    cookedPath(mesh, path, sizeof(path), hash);
+
+    std::vector<double> buildSeconds(iterations), cookedSeconds(iterations);
+    for (int i = 0; i < iterations; i++) {
+        TerrainCollision built;
+        double start = PerfNowSeconds();
+        BuildTerrainShape(physicsCommon, mesh, built);
+        buildSeconds[i] = PerfNowSeconds() - start;
+        DestroyTerrain(physicsCommon, built);
+
+        TerrainCollision restored;
+        CookedMesh cooked;
+        start = PerfNowSeconds();
+        bool ok = LoadCookedMesh(&cooked, path, hash) && RestoreTerrainShape(physicsCommon, cooked, restored);
+        UnloadCookedMesh(&cooked);
+        cookedSeconds[i] = PerfNowSeconds() - start;
+        DestroyTerrain(physicsCommon, restored);
+
+        if (!ok) {
+            std::cerr << "Terrain benchmark aborted: cannot load " << path << "\n";
+            return;
+        }
+    }
+
+    ReportCookBenchmark("ReactPhysics3D ConcaveMeshShape", &mesh, buildSeconds.data(), cookedSeconds.data(), iterations);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// Static terrain ConcaveMeshShape: built from the raw triangles, or from the
+// cooked cache. ReactPhysics3D cannot serialize its triangle AABB tree, so the
+// cooked file stores the precomputed vertex normals instead and the mapped
+// arrays are handed to createTriangleMesh without any conversion pass.
+
+#include <reactphysics3d/reactphysics3d.h>
+
+#include "terrain_mesh.h"
+
+struct TerrainCollision {
+    reactphysics3d::TriangleMesh* triangleMesh = nullptr;
+    reactphysics3d::ConcaveMeshShape* shape = nullptr;
+    bool fromCache = false;
+};
+
+// Lets ReactPhysics3D weld, validate and compute normals for the raw triangles
+bool BuildTerrainShape(reactphysics3d::PhysicsCommon& physicsCommon, const TerrainMesh& mesh, TerrainCollision& terrain);
+
+// Creates the shape from a cooked file, normals included
+bool RestoreTerrainShape(reactphysics3d::PhysicsCommon& physicsCommon, const CookedMesh& cooked, TerrainCollision& terrain);
+
+// Uses the cooked file for this mesh when present, otherwise builds and writes it
+bool LoadOrCookTerrain(reactphysics3d::PhysicsCommon& physicsCommon, const TerrainMesh& mesh, TerrainCollision& terrain);
+
+void DestroyTerrain(reactphysics3d::PhysicsCommon& physicsCommon, TerrainCollision& terrain);
+
+// Times both startup paths and prints the comparison
+void RunTerrainCookBenchmark(reactphysics3d::PhysicsCommon& physicsCommon, const TerrainMesh& mesh, int iterations);
@@ -0,0 +1,4 @@
+@echo off
+cmake -S . -B build -DCMAKE_BUILD_TYPE=Debug
+cmake --build build --config Debug
+
@@ -0,0 +1,117 @@
+// Headless shared state tool: attaches to a demo running with --shm, records
+// every publish it sees and reports how it kept up. Like the viewer it can be
+// started and stopped at any time, the demo never waits for it.
+//
+//   shm_recorder [name] [seconds] [output file]
+//
+// Output records: uint64 publish index, double publish seconds, uint32 body
+// count, uint32 padding, then body count BodyStates.
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "perf_timer.h"
+#include "shared_state.h"
+
+#define POLL_SECONDS 0.001     // Several polls per publish at any demo rate, and the core stays free for the demo
+
+static int compareFloat(const void *a, const void *b) {
+    float fa = *(const float *)a, fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+static float percentile(const float *sorted, int count, float p) {
+    if (count == 0) return 0.0f;
+    int index = (int)((float)(count - 1) * p / 100.0f + 0.5f);
+    return sorted[index];
+}
+
+int main(int argc, char **argv) {
+    const char *name = argc > 1 ? argv[1] : SHARED_STATE_DEFAULT_NAME;
+    double duration = argc > 2 ? atof(argv[2]) : 10.0;
+    const char *path = argc > 3 ? argv[3] : NULL;
+
+    SharedStateReader reader;
+    double start = PerfNowSeconds();
+    while (!OpenSharedStateReader(&reader, name)) {
+        if (PerfNowSeconds() - start > 3.0) {
+            printf("Recorder: no demo publishing \"%s\" (--shm)\n", name);
+            return 1;
+        }
+        PerfSleepUntil(PerfNowSeconds() + 0.1);
+    }
+
+    PerfBeginSleepResolution();
+    int capacity = (int)reader.header->capacity;
+    BodyState *states = (BodyState *)malloc(sizeof(BodyState) * (size_t)capacity);
+    if (!states) {
+        printf("Recorder: out of memory for %d bodies\n", capacity);
+        CloseSharedStateReader(&reader);
+        return 1;
+    }
+    FILE *file = path ? fopen(path, "wb") : NULL;
+    if (path && !file) printf("Recorder: cannot write %s, only measuring\n", path);
+    printf("Recorder: %s, %d bodies, for %.0f s\n", reader.header->engine, capacity, duration);
+
+    int latencyCapacity = 4096;
+    int latencyCount = 0;
+    float *latencies = (float *)malloc(sizeof(float) * (size_t)latencyCapacity);
+    bool latenciesFull = !latencies;    // Out of memory: publishes are still recorded, ages no longer kept
+    uint64_t firstIndex = 0, lastIndex = 0, frames = 0, failedReads = 0, bytes = 0;
+
+    start = PerfNowSeconds();
+    while (PerfNowSeconds() - start < duration && IsSharedStateWriterActive(&reader)) {
+        uint64_t index;
+        double published;
+        int count = ReadSharedState(&reader, states, capacity, &index, &published);
+        double now = PerfNowSeconds();
+
+        if (count < 0) {
+            failedReads++;
+        } else if (index != lastIndex) {
+            if (!firstIndex) firstIndex = index;
+            lastIndex = index;
+            frames++;
+
+            if (!latenciesFull && latencyCount == latencyCapacity) {
+                float *grown = (float *)realloc(latencies, sizeof(float) * (size_t)latencyCapacity * 2);
+                if (grown) {
+                    latencies = grown;
+                    latencyCapacity *= 2;
+                } else {
+                    latenciesFull = true;
+                }
+            }
+            if (!latenciesFull) latencies[latencyCount++] = (float)((now - published) * 1000.0);
+
+            if (file) {
+                uint32_t header[2] = { (uint32_t)count, 0 };
+                fwrite(&index, sizeof(index), 1, file);
+                fwrite(&published, sizeof(published), 1, file);
+                fwrite(header, sizeof(header), 1, file);
+                fwrite(states, sizeof(BodyState), (size_t)count, file);
+                bytes += sizeof(index) + sizeof(published) + sizeof(header) + sizeof(BodyState) * (size_t)count;
+            }
+        }
+        PerfSleepSeconds(POLL_SECONDS);
+    }
+    PerfEndSleepResolution();
+    bool writerGone = !IsSharedStateWriterActive(&reader);
+    CloseSharedStateReader(&reader);
+    if (file) fclose(file);
+
+    if (latencyCount > 0) qsort(latencies, (size_t)latencyCount, sizeof(float), compareFloat);
+    uint64_t span = frames ? lastIndex - firstIndex + 1 : 0;
+    printf("Publishes seen    %llu of %llu (%llu missed)\n", (unsigned long long)frames,
+           (unsigned long long)span, (unsigned long long)(span - frames));
+    printf("Failed reads      %llu (nothing published, or torn on every retry)\n", (unsigned long long)failedReads);
+    printf("Age at read       p50 %.3f ms  p99 %.3f ms  max %.3f ms  (publish -> copied)\n",
+           percentile(latencies, latencyCount, 50.0f), percentile(latencies, latencyCount, 99.0f),
+           percentile(latencies, latencyCount, 100.0f));
+    if (file) printf("Recorded          %.1f kB to %s\n", (double)bytes / 1024.0, path);
+    if (writerGone) printf("Demo stopped publishing, detached early\n");
+    if (latenciesFull) printf("Out of memory: ages cover the first %d publishes only\n", latencyCount);
+
+    free(latencies);
+    free(states);
+    return 0;
+}
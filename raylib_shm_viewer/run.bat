@@ -0,0 +1,3 @@
+@echo off
+cd build/Debug
+shm_viewer.exe %*
\ No newline at end of file
@@ -0,0 +1,133 @@
+// Out-of-process viewer for a demo running with --shm: maps the demo's shared
+// state read-only and draws the bodies straight from the mapping, no copy.
+// Start and close it at any time; it attaches when a demo publishes and
+// detaches when the demo exits or stops publishing.
+//
+//   shm_viewer [name]
+#include <stdio.h>
+#include "raylib.h"
+#include "raymath.h"
+#include "perf_timer.h"
+#include "shared_state.h"
+
+#define ATTACH_INTERVAL 0.5     // Seconds between attach attempts while detached
+#define STALL_SECONDS 2.0       // No publish for this long: the demo hung or died, look for a new segment
+
+// Publish index of the latest frame, 0 when nothing is published yet
+static uint64_t latestPublishIndex(const SharedStateReader *reader) {
+    SharedStateView view;
+    if (!BeginSharedStateRead(reader, &view)) return 0;
+    uint64_t index = view.frame->publishIndex;
+    return EndSharedStateRead(reader, &view) ? index : 0;
+}
+
+int main(int argc, char **argv) {
+    const char *name = argc > 1 ? argv[1] : SHARED_STATE_DEFAULT_NAME;
+
+    InitWindow(800, 600, "Shared State Viewer - RMB: Fly");
+    SetTargetFPS(60);
+
+    Camera3D camera = { 0 };
+    camera.position = (Vector3){ 0.0f, 10.0f, 10.0f };
+    camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };
+    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 45.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    Model cube_model = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
+
+    SharedStateReader reader = { 0 };
+    double next_attach = 0.0;
+    uint64_t last_index = 0;
+    uint64_t skipped = 0;       // Publishes that happened between two drawn frames
+    uint64_t torn = 0;          // Frames the writer reused while they were drawn
+    double age = 0.0;           // Publish to draw, seconds
+    int body_count = 0;
+    // Segment let go of as closed or stalled. A crashed demo leaves it behind
+    // under the name, it is only picked up again once a new demo replaces it
+    // or the stalled one publishes again.
+    uint64_t abandoned_id = 0;
+    uint64_t abandoned_index = 0;
+
+    while (!WindowShouldClose()) {
+        if (IsMouseButtonDown(MOUSE_BUTTON_RIGHT)) UpdateCamera(&camera, CAMERA_FREE);
+
+        double now = PerfNowSeconds();
+        if (!reader.header && now >= next_attach) {
+            if (OpenSharedStateReader(&reader, name) && reader.header->segmentId == abandoned_id &&
+                (!IsSharedStateWriterActive(&reader) || latestPublishIndex(&reader) == abandoned_index)) {
+                CloseSharedStateReader(&reader);
+            }
+            if (reader.header) {
+                abandoned_id = 0;
+                last_index = 0;
+                skipped = 0;
+                torn = 0;
+                age = 0.0;
+            }
+            next_attach = now + ATTACH_INTERVAL;
+        }
+
+        SharedStateView view;
+        bool reading = reader.header && BeginSharedStateRead(&reader, &view);
+
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+        BeginMode3D(camera);
+
+        DrawPlane((Vector3){ 0, 0, 0 }, (Vector2){ 10, 10 }, GRAY);
+        if (reading) {
+            for (int i = 0; i < view.bodyCount; i++) {
+                const BodyState *body = &view.bodies[i];
+                Quaternion q = { body->rotation[0], body->rotation[1], body->rotation[2], body->rotation[3] };
+                Matrix scale = MatrixScale(body->halfExtents[0] * 2.0f, body->halfExtents[1] * 2.0f, body->halfExtents[2] * 2.0f);
+                Matrix translate = MatrixTranslate(body->position[0], body->position[1], body->position[2]);
+                cube_model.transform = MatrixMultiply(MatrixMultiply(scale, QuaternionToMatrix(q)), translate);
+                DrawModel(cube_model, (Vector3){ 0, 0, 0 }, 1.0f, i == 0 ? RED : ORANGE);
+                DrawModelWires(cube_model, (Vector3){ 0, 0, 0 }, 1.0f, BLACK);
+            }
+        }
+
+        EndMode3D();
+
+        if (reading) {
+            uint64_t index = view.frame->publishIndex;
+            double published = view.frame->publishSeconds;
+            body_count = view.bodyCount;
+            // A torn frame mixed two steps on screen for one frame, the next one is whole again
+            if (!EndSharedStateRead(&reader, &view)) {
+                torn++;
+            } else {
+                if (last_index && index > last_index + 1) skipped += index - last_index - 1;
+                last_index = index;
+                age = now - published;
+            }
+        }
+
+        DrawFPS(10, 10);
+        DrawText("Hold RMB: Fly camera", 10, 30, 20, DARKGRAY);
+        if (!reader.header) {
+            DrawText(TextFormat("Waiting for a demo publishing \"%s\" (--shm)", name), 10, 60, 20, MAROON);
+        } else {
+            DrawText(TextFormat("%s: %d bodies, publish %llu", reader.header->engine, body_count,
+                                (unsigned long long)last_index), 10, 60, 20, DARKGRAY);
+            DrawText(TextFormat("Age: %.2f ms  Skipped: %llu  Torn: %llu", age * 1000.0,
+                                (unsigned long long)skipped, (unsigned long long)torn), 10, 90, 20, DARKGRAY);
+        }
+
+        EndDrawing();
+
+        // Let go of a segment the demo closed or abandoned so the next run is picked up
+        if (reader.header && (!IsSharedStateWriterActive(&reader) || age > STALL_SECONDS)) {
+            abandoned_id = reader.header->segmentId;
+            abandoned_index = latestPublishIndex(&reader);
+            CloseSharedStateReader(&reader);
+            next_attach = now;
+        }
+    }
+
+    CloseSharedStateReader(&reader);
+    UnloadModel(cube_model);
+    CloseWindow();
+    return 0;
+}